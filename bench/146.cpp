@@ -0,0 +1,127 @@
+#include "problems/146.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+// Zipf distributed keys (s = 0.99) out of `num_keys`
+static std::vector<int> makeZipfKeys(std::size_t num_keys) {
+    std::vector<double> weights(num_keys);
+    for (std::size_t i = 0; i < num_keys; ++i) {
+        weights[i] = 1.0 / std::pow(static_cast<double>(i + 1), 0.99);
+    }
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+    // spread the popular keys around so they don't hash next to each other
+    std::vector<int> keys(1 << 16);
+    for (auto &key : keys) { key = static_cast<int>(zipf(rng) * 2654435761u); }
+    return keys;
+}
+
+// cache-aside workload over keys drawn from a key space 4x the capacity,
+// i.e. get() and put() on a miss
+static void BM_LRUCache(benchmark::State &state) {
+    auto capacity = static_cast<std::size_t>(state.range(0));
+    auto keys = makeZipfKeys(4 * capacity);
+
+    LRUCache cache(capacity);
+    std::size_t i = 0;
+    std::int64_t misses = 0;
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto key = keys[i++ % keys.size()];
+        if (cache.get(key) == -1) {
+            cache.put(key, key);
+            misses += 1;
+        }
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["miss_rate"] = benchmark::Counter(
+            static_cast<double>(misses) / static_cast<double>(state.iterations()));
+}
+
+BENCHMARK(BM_LRUCache)->RangeMultiplier(8)->Range(1 << 4, 1 << 19);
+
+// LRUCache behind a single mutex, the straightforward way to share one
+class LockedLRUCache {
+public:
+    explicit LockedLRUCache(std::size_t capacity) : cache_(capacity) {}
+
+    int get(int key) {
+        std::lock_guard lock(mutex_);
+        return cache_.get(key);
+    }
+
+    void put(int key, int value) {
+        std::lock_guard lock(mutex_);
+        cache_.put(key, value);
+    }
+
+private:
+    std::mutex mutex_;
+    LRUCache cache_;
+};
+
+// thread_index is a member in the pinned v1.5.5 and a function in later releases
+template<class State>
+static auto threadIndex(const State &state) -> decltype(int(state.thread_index)) {
+    return state.thread_index;
+}
+
+template<class State>
+static auto threadIndex(const State &state) -> decltype(state.thread_index()) {
+    return state.thread_index();
+}
+
+// one cache shared by all threads, with 31 out of 32 operations being a
+// get() and the rest a put(), over keys from a key space 4x the capacity.
+// The key sequence has about 2.5x as many distinct keys as fit in the
+// cache, so puts also insert and evict while the readers are running.
+template<class Cache>
+static void BM_LRUCacheReadHeavy(benchmark::State &state) {
+    constexpr std::size_t capacity = 1 << 12;
+    static std::vector<int> keys;
+    static std::unique_ptr<Cache> cache;
+
+    // the other threads wait for this at the start of the benchmark loop
+    if (threadIndex(state) == 0) {
+        keys = makeZipfKeys(4 * capacity);
+        cache = std::make_unique<Cache>(capacity);
+        for (auto key : keys) { cache->put(key, key); }
+    }
+
+    // spread the threads out over the key sequence
+    auto i = static_cast<std::size_t>(threadIndex(state)) * 7919;
+    std::int64_t gets = 0;
+    std::int64_t hits = 0;
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto key = keys[i++ % keys.size()];
+        if (i % 32 == 0) {
+            cache->put(key, key);
+        } else {
+            gets += 1;
+            hits += cache->get(key) != -1;
+        }
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hit_rate"] = benchmark::Counter(
+            static_cast<double>(hits) / static_cast<double>(std::max<std::int64_t>(gets, 1)),
+            benchmark::Counter::kAvgThreads);
+
+    if (threadIndex(state) == 0) {
+        cache.reset();
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_LRUCacheReadHeavy, LockedLRUCache)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_LRUCacheReadHeavy, ConcurrentLRUCache)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,240 @@
+#include "problems/173.h"
+
+#include <algorithm>
+#include <random>
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+// complete-ish tree holding [first, last]
+static TreeNode makeBalancedTree(int first, int last) {
+    int mid = first + (last - first) / 2;
+    if (first == last) {
+        return TreeNode(mid);
+    } else if (first == mid) {
+        return TreeNode(mid, makeBalancedTree(mid + 1, last));
+    } else {
+        return TreeNode(makeBalancedTree(first, mid - 1), mid, makeBalancedTree(mid + 1, last));
+    }
+}
+
+// tree holding [1, n] where every node only has a right child, e.g.
+// from inserting sorted keys without rebalancing
+static TreeNode makeSkewedTree(int n) {
+    TreeNode root(n);
+    for (int i = n - 1; i >= 1; --i) {
+        root = TreeNode(i, std::move(root));
+    }
+    return root;
+}
+
+static TreeNode makeBalancedTree(int n) {
+    return makeBalancedTree(1, n);
+}
+
+template<class Iter>
+static long long sumAll(Iter &iter) {
+    long long sum = 0;
+    while (iter.hasNext()) {
+        sum += iter.next();
+    }
+    return sum;
+}
+
+static void BM_BSTIterator(benchmark::State &state, TreeNode (*make)(int)) {
+    auto root = make(static_cast<int>(state.range(0)));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto iter = BSTIterator(&root);
+        benchmark::DoNotOptimize(sumAll(iter));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MorrisBSTIterator(benchmark::State &state, TreeNode (*make)(int)) {
+    auto root = make(static_cast<int>(state.range(0)));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto iter = MorrisBSTIterator(&root);
+        benchmark::DoNotOptimize(sumAll(iter));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ThreadedBSTIterator(benchmark::State &state, TreeNode (*make)(int)) {
+    auto root = make(static_cast<int>(state.range(0)));
+    auto threaded = ThreadedBST(&root);
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto iter = ThreadedBSTIterator(threaded);
+        benchmark::DoNotOptimize(sumAll(iter));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// skewed trees are kept smaller since destroying them recurses once per node
+BENCHMARK_CAPTURE(BM_BSTIterator, balanced, makeBalancedTree)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK_CAPTURE(BM_MorrisBSTIterator, balanced, makeBalancedTree)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK_CAPTURE(BM_ThreadedBSTIterator, balanced, makeBalancedTree)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK_CAPTURE(BM_BSTIterator, skewed, makeSkewedTree)->RangeMultiplier(4)->Range(1 << 8, 1 << 14);
+BENCHMARK_CAPTURE(BM_MorrisBSTIterator, skewed, makeSkewedTree)->RangeMultiplier(4)->Range(1 << 8, 1 << 14);
+BENCHMARK_CAPTURE(BM_ThreadedBSTIterator, skewed, makeSkewedTree)->RangeMultiplier(4)->Range(1 << 8, 1 << 14);
+
+// keys are 0, 2, 4, ... so that about half of the random queries miss
+static std::vector<int> makeEvenKeys(std::size_t n) {
+    std::vector<int> keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(2 * i);
+    }
+    return keys;
+}
+
+static std::vector<int> makeQueries(std::size_t n) {
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * n));
+    std::vector<int> queries(1 << 16);
+    for (auto &query : queries) { query = dist(rng); }
+    return queries;
+}
+
+static void BM_lowerBoundSorted(benchmark::State &state) {
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto keys = makeEvenKeys(n);
+    auto queries = makeQueries(n);
+    std::size_t i = 0;
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto query = queries[i++ % queries.size()];
+        benchmark::DoNotOptimize(std::lower_bound(keys.begin(), keys.end(), query));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Layout>
+static void BM_lowerBoundFrozen(benchmark::State &state) {
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto tree = FrozenBST<Layout>(makeEvenKeys(n));
+    auto queries = makeQueries(n);
+    std::size_t i = 0;
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto query = queries[i++ % queries.size()];
+        benchmark::DoNotOptimize(tree.lowerBound(query));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Layout>
+static void BM_scanFrozen(benchmark::State &state) {
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto tree = FrozenBST<Layout>(makeEvenKeys(n));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        long long sum = 0;
+        for (auto key : tree) { sum += key; }
+        benchmark::DoNotOptimize(sum);
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_lowerBoundSorted)->RangeMultiplier(10)->Range(1'000, 100'000'000);
+BENCHMARK_TEMPLATE(BM_lowerBoundFrozen, EytzingerLayout)->RangeMultiplier(10)->Range(1'000, 100'000'000);
+BENCHMARK_TEMPLATE(BM_lowerBoundFrozen, VanEmdeBoasLayout)->RangeMultiplier(10)->Range(1'000, 100'000'000);
+BENCHMARK_TEMPLATE(BM_scanFrozen, EytzingerLayout)->RangeMultiplier(10)->Range(1'000, 100'000'000);
+BENCHMARK_TEMPLATE(BM_scanFrozen, VanEmdeBoasLayout)->RangeMultiplier(10)->Range(1'000, 100'000'000);
+
+// keys in [first, first + 16) from a balanced tree of n keys,
+// using seek() vs skipping keys one at a time
+static void BM_rangeLinearSkip(benchmark::State &state) {
+    auto n = static_cast<int>(state.range(0));
+    auto root = makeBalancedTree(n);
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> dist(1, n);
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        int first = dist(rng);
+        auto iter = BSTIterator(&root);
+        long long sum = 0;
+        for (int taken = 0; iter.hasNext() && taken < 16;) {
+            int key = iter.next();
+            if (key >= first) {
+                sum += key;
+                taken += 1;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    counters.stop();
+}
+
+static void BM_rangeSeek(benchmark::State &state) {
+    auto n = static_cast<int>(state.range(0));
+    auto root = makeBalancedTree(n);
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> dist(1, n);
+    auto iter = BSTIterator(&root);
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        iter.seek(dist(rng));
+        long long sum = 0;
+        for (int taken = 0; iter.hasNext() && taken < 16; ++taken) {
+            sum += iter.next();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    counters.stop();
+}
+
+static void BM_nthLinearSkip(benchmark::State &state) {
+    auto n = static_cast<int>(state.range(0));
+    auto root = makeBalancedTree(n);
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> dist(0, n - 1);
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto iter = BSTIterator(&root);
+        for (int k = dist(rng); k > 0; --k) {
+            iter.next();
+        }
+        benchmark::DoNotOptimize(iter.next());
+    }
+    counters.stop();
+}
+
+static void BM_nthOrderStatistic(benchmark::State &state) {
+    auto n = static_cast<int>(state.range(0));
+    auto root = makeBalancedTree(n);
+    auto stats = OrderStatisticBST(&root);
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stats.nth(dist(rng)));
+    }
+    counters.stop();
+}
+
+static void BM_rankOrderStatistic(benchmark::State &state) {
+    auto n = static_cast<int>(state.range(0));
+    auto root = makeBalancedTree(n);
+    auto stats = OrderStatisticBST(&root);
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> dist(1, n);
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stats.rank(dist(rng)));
+    }
+    counters.stop();
+}
+
+BENCHMARK(BM_rangeLinearSkip)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_rangeSeek)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_nthLinearSkip)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_nthOrderStatistic)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_rankOrderStatistic)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
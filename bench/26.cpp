@@ -0,0 +1,29 @@
+#include "problems/26.h"
+
+#include <algorithm>
+#include <random>
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+// sorted input where every value is repeated about 4 times, the copy
+// is part of the timing since removeDuplicates works in place
+static void BM_removeDuplicates(benchmark::State &state) {
+    auto n = static_cast<std::size_t>(state.range(0));
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(n / 4));
+    std::vector<int> input(n);
+    for (auto &x : input) { x = dist(rng); }
+    std::sort(input.begin(), input.end());
+
+    std::vector<int> nums;
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        nums = input;
+        benchmark::DoNotOptimize(Solution::removeDuplicates(nums));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_removeDuplicates)->RangeMultiplier(8)->Range(1 << 6, 1 << 21);
@@ -0,0 +1,110 @@
+#include "problems/278.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+// sorted keys with uniformly distributed gaps
+static std::vector<int> makeSortedData(std::size_t n) {
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> gap_dist(1, 16);
+    std::vector<int> data(n);
+    int value = 0;
+    for (auto &x : data) {
+        value += gap_dist(rng);
+        x = value;
+    }
+    return data;
+}
+
+// queries spread over the whole array, or mostly near the front
+static std::vector<int> makeUniformQueries(const std::vector<int> &data) {
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> dist(0, data.back());
+    std::vector<int> queries(1 << 16);
+    for (auto &query : queries) { query = dist(rng); }
+    return queries;
+}
+
+static std::vector<int> makeHeadQueries(const std::vector<int> &data) {
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::geometric_distribution<std::size_t> dist(0.01);
+    std::vector<int> queries(1 << 16);
+    for (auto &query : queries) { query = data[std::min(dist(rng), data.size() - 1)]; }
+    return queries;
+}
+
+using QueryMaker = std::vector<int> (*)(const std::vector<int> &);
+
+using LowerBound = std::size_t (*)(std::span<const int>, int);
+
+static void BM_lowerBound(benchmark::State &state, LowerBound lower_bound, QueryMaker make_queries) {
+    auto data = makeSortedData(static_cast<std::size_t>(state.range(0)));
+    auto queries = make_queries(data);
+    std::size_t i = 0;
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lower_bound(data, queries[i++ % queries.size()]));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations());
+}
+
+static std::size_t stdLowerBound(std::span<const int> data, int key) {
+    return static_cast<std::size_t>(std::lower_bound(data.begin(), data.end(), key) - data.begin());
+}
+
+static void BM_lowerBoundBatch(benchmark::State &state, QueryMaker make_queries) {
+    auto data = makeSortedData(static_cast<std::size_t>(state.range(0)));
+    auto queries = make_queries(data);
+    std::vector<std::size_t> out(queries.size());
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        search::lowerBoundBatch(data, queries, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queries.size()));
+}
+
+#define SEARCH_BENCHMARKS(queries)                                                                  \
+    BENCHMARK_CAPTURE(BM_lowerBound, std/queries, stdLowerBound, make##queries)                     \
+            ->RangeMultiplier(8)->Range(1 << 10, 1 << 25);                                          \
+    BENCHMARK_CAPTURE(BM_lowerBound, branchless/queries, search::lowerBound, make##queries)         \
+            ->RangeMultiplier(8)->Range(1 << 10, 1 << 25);                                          \
+    BENCHMARK_CAPTURE(BM_lowerBound, interpolation/queries, search::interpolationLowerBound,        \
+                      make##queries)->RangeMultiplier(8)->Range(1 << 10, 1 << 25);                  \
+    BENCHMARK_CAPTURE(BM_lowerBound, exponential/queries, search::exponentialLowerBound,            \
+                      make##queries)->RangeMultiplier(8)->Range(1 << 10, 1 << 25);                  \
+    BENCHMARK_CAPTURE(BM_lowerBoundBatch, queries, make##queries)->RangeMultiplier(8)->Range(1 << 10, 1 << 25)
+
+SEARCH_BENCHMARKS(UniformQueries);
+SEARCH_BENCHMARKS(HeadQueries);
+
+// wall-clock time to bisect 1e6 versions with a 100us check
+static void BM_firstTrueSlowPredicate(benchmark::State &state) {
+    auto arity = static_cast<std::size_t>(state.range(0));
+    auto slowIsBad = [](int m) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        return m >= 123'456;
+    };
+
+    WorkStealingPool pool{arity - 1};
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        if (arity == 2) {
+            benchmark::DoNotOptimize(Solution::firstBadVersion(1'000'000, slowIsBad));
+        } else {
+            benchmark::DoNotOptimize(search::firstTrueParallel(1, 1'000'001, arity, slowIsBad, pool));
+        }
+    }
+    counters.stop();
+}
+
+// arity 2 is plain sequential binary search
+BENCHMARK(BM_firstTrueSlowPredicate)->DenseRange(2, 8, 2)->UseRealTime();
@@ -0,0 +1,26 @@
+#include "problems/284.h"
+
+#include <numeric>
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+static void BM_PeekingIterator(benchmark::State &state) {
+    auto nums = std::vector<int>(state.range(0));
+    std::iota(nums.begin(), nums.end(), 0);
+
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        auto iter = PeekingIterator(nums);
+        long long sum = 0;
+        while (iter.hasNext()) {
+            sum += iter.peek();
+            sum += iter.next();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PeekingIterator)->RangeMultiplier(8)->Range(1 << 6, 1 << 21);
@@ -0,0 +1,123 @@
+#include "problems/341.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+// `n` integers in lists of 1024 integers each
+static std::vector<NestedInteger> makeWideNested(int n) {
+    std::vector<NestedInteger> nested;
+    for (int i = 0; i < n; i += 1024) {
+        std::vector<NestedInteger> list;
+        list.reserve(1024);
+        for (int j = i; j < std::min(n, i + 1024); ++j) {
+            list.emplace_back(j);
+        }
+        nested.emplace_back(std::move(list));
+    }
+    return nested;
+}
+
+// `n` integers in chains of 256 lists nested inside each other,
+// e.g. [0, [1, [2, [...]]]]
+static std::vector<NestedInteger> makeDeepNested(int n) {
+    std::vector<NestedInteger> nested;
+    for (int i = 0; i < n; i += 256) {
+        int last = std::min(n, i + 256) - 1;
+        NestedInteger chain = std::vector<NestedInteger>{last};
+        for (int j = last - 1; j >= i; --j) {
+            std::vector<NestedInteger> list;
+            list.reserve(2);
+            list.emplace_back(j);
+            list.emplace_back(std::move(chain));
+            chain = NestedInteger(std::move(list));
+        }
+        nested.push_back(std::move(chain));
+    }
+    return nested;
+}
+
+template<class Iter>
+static long long sumAll(Iter it) {
+    long long sum = 0;
+    while (it.hasNext()) {
+        sum += it.next();
+    }
+    return sum;
+}
+
+static void BM_NestedIterator(benchmark::State &state, std::vector<NestedInteger> (*make)(int)) {
+    auto nested = make(static_cast<int>(state.range(0)));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sumAll(NestedIterator(nested)));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FlatNestedIterator(benchmark::State &state, std::vector<NestedInteger> (*make)(int)) {
+    auto flat = FlatNestedList(make(static_cast<int>(state.range(0))));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sumAll(FlatNestedIterator(flat)));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_NestedIterator, wide, makeWideNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22);
+BENCHMARK_CAPTURE(BM_FlatNestedIterator, wide, makeWideNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22);
+BENCHMARK_CAPTURE(BM_NestedIterator, deep, makeDeepNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22);
+BENCHMARK_CAPTURE(BM_FlatNestedIterator, deep, makeDeepNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22);
+
+// bracketed text for the result of `make(n)`, e.g. "[[0,1],[2,3]]"
+static std::string toText(const std::vector<NestedInteger> &nested) {
+    std::string text = "[";
+    for (auto &item : nested) {
+        if (text.size() > 1) { text += ','; }
+        text += item.isInteger() ? std::to_string(item.getInteger()) : toText(item.getList());
+    }
+    text += ']';
+    return text;
+}
+
+static void BM_NestedTextIterator(benchmark::State &state, std::vector<NestedInteger> (*make)(int)) {
+    auto text = toText(make(static_cast<int>(state.range(0))));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sumAll(NestedTextIterator(text)));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+BENCHMARK_CAPTURE(BM_NestedTextIterator, wide, makeWideNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22);
+BENCHMARK_CAPTURE(BM_NestedTextIterator, deep, makeDeepNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22);
+
+static void BM_parallelFlatten(benchmark::State &state, std::vector<NestedInteger> (*make)(int)) {
+    auto nested = make(static_cast<int>(state.range(0)));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parallelFlatten(nested));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_parallelReduce(benchmark::State &state, std::vector<NestedInteger> (*make)(int)) {
+    auto nested = make(static_cast<int>(state.range(0)));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parallelReduce(nested, 0LL, std::plus<>()));
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_parallelFlatten, wide, makeWideNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22)->UseRealTime();
+BENCHMARK_CAPTURE(BM_parallelFlatten, deep, makeDeepNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22)->UseRealTime();
+BENCHMARK_CAPTURE(BM_parallelReduce, wide, makeWideNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22)->UseRealTime();
+BENCHMARK_CAPTURE(BM_parallelReduce, deep, makeDeepNested)->RangeMultiplier(4)->Range(1 << 16, 1 << 22)->UseRealTime();
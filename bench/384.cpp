@@ -0,0 +1,21 @@
+#include "problems/384.h"
+
+#include <numeric>
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+static void BM_shuffle(benchmark::State &state) {
+    auto nums = std::vector<int>(state.range(0));
+    std::iota(nums.begin(), nums.end(), 0);
+
+    auto sol = Solution(std::move(nums));
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sol.shuffle());
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_shuffle)->RangeMultiplier(8)->Range(1 << 3, 1 << 18);
@@ -0,0 +1,47 @@
+#include "problems/44.h"
+
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+// `n` characters of repeated "abc...z" against "a*b*c*...", like the
+// first pathological case above
+static void BM_isMatchAlternating(benchmark::State &state) {
+    std::string input;
+    std::string pattern;
+    for (int i = 0; i < state.range(0); ++i) {
+        char next = static_cast<char>('a' + (i % 26));
+        input += next;
+        pattern += next;
+        pattern += '*';
+    }
+
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Solution::isMatch(input, pattern));
+    }
+    counters.stop();
+    state.SetComplexityN(state.range(0));
+}
+
+// `n` 'a's (starting with a 'z') against "*z*?*?*?...", which forces
+// exploring every split of the input between wildcards
+static void BM_isMatchWildcardRuns(benchmark::State &state) {
+    std::string input(state.range(0), 'a');
+    input[0] = 'z';
+    std::string pattern;
+    for (int i = 0; i < state.range(0); ++i) {
+        pattern += "*?";
+    }
+    pattern[1] = 'z';
+
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Solution::isMatch(input, pattern));
+    }
+    counters.stop();
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_isMatchAlternating)->RangeMultiplier(4)->Range(16, 1024)->Complexity();
+BENCHMARK(BM_isMatchWildcardRuns)->RangeMultiplier(4)->Range(16, 1024)->Complexity();
@@ -0,0 +1,37 @@
+#include "problems/88.h"
+
+#include <algorithm>
+#include <random>
+#include <benchmark/benchmark.h>
+
+#include "bench_counters.h"
+
+// two sorted halves of random values, the copy is part of the timing
+// since merge works in place
+static void BM_merge(benchmark::State &state) {
+    auto n = static_cast<int>(state.range(0));
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::uniform_int_distribution<int> dist;
+    auto makeSorted = [&](int size) {
+        std::vector<int> nums(size);
+        for (auto &x : nums) { x = dist(rng); }
+        std::sort(nums.begin(), nums.end());
+        return nums;
+    };
+
+    auto input1 = makeSorted(n);
+    input1.resize(2 * n, 0);
+    auto input2 = makeSorted(n);
+
+    std::vector<int> nums1;
+    BenchmarkCounters counters(state);
+    for (auto _ : state) {
+        nums1 = input1;
+        Solution::merge(nums1, n, input2, n);
+        benchmark::DoNotOptimize(nums1.data());
+    }
+    counters.stop();
+    state.SetItemsProcessed(state.iterations() * 2 * state.range(0));
+}
+
+BENCHMARK(BM_merge)->RangeMultiplier(8)->Range(1 << 6, 1 << 21);
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <benchmark/benchmark.h>
+
+#include "util/instrument.h"
+
+// Reports heap allocations and hardware counters per iteration as custom
+// counters of a benchmark when built with -DLEETCODE_INSTRUMENT=ON, and
+// does nothing otherwise. Everything between construction and stop() is
+// counted, so construct it right before the benchmark loop and stop it
+// right after, before any teardown:
+//
+//     BenchmarkCounters counters(state);
+//     for (auto _ : state) { ... }
+//     counters.stop();
+//
+// If stop() isn't called, the destructor does it instead.
+//
+// Both kinds of counters only cover the benchmark's own thread, work done
+// on a thread pool isn't included.
+class BenchmarkCounters {
+public:
+    explicit BenchmarkCounters(benchmark::State &state) : state_(state) {
+#ifdef LEETCODE_INSTRUMENT
+        if (!perf_.anyAvailable()) {
+            static std::atomic<bool> warned = false;
+            if (!warned.exchange(true)) {
+                std::fprintf(stderr, "perf_event_open failed (%s), not reporting hardware counters\n",
+                             std::strerror(perf_.error()));
+            }
+        }
+        for (std::size_t i = 0; i < instrument::num_events; ++i) {
+            start_[i] = perf_.read(static_cast<instrument::Event>(i));
+        }
+        allocations_ = instrument::allocationStats();
+#endif
+    }
+
+    BenchmarkCounters(const BenchmarkCounters &) = delete;
+    BenchmarkCounters &operator=(const BenchmarkCounters &) = delete;
+
+    ~BenchmarkCounters() {
+        stop();
+    }
+
+    // Takes the end readings and reports the counters, only the first call does anything.
+    void stop() {
+        if (stopped_) { return; }
+        stopped_ = true;
+#ifdef LEETCODE_INSTRUMENT
+        // read everything first so that setting the counters isn't counted
+        std::optional<std::uint64_t> end[instrument::num_events];
+        for (std::size_t i = 0; i < instrument::num_events; ++i) {
+            end[i] = perf_.read(static_cast<instrument::Event>(i));
+        }
+        auto allocations = instrument::allocationStats();
+
+        auto perIteration = [](double value) {
+            return benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+        };
+        if (instrument::allocationsTracked()) {
+            state_.counters["allocs"] = perIteration(
+                    static_cast<double>(allocations.allocations_ - allocations_.allocations_));
+            state_.counters["alloc_bytes"] = perIteration(
+                    static_cast<double>(allocations.bytes_ - allocations_.bytes_));
+        }
+
+        std::optional<double> delta[instrument::num_events];
+        for (std::size_t i = 0; i < instrument::num_events; ++i) {
+            if (!start_[i] || !end[i]) { continue; }
+            delta[i] = static_cast<double>(*end[i] - *start_[i]);
+            state_.counters[instrument::eventName(static_cast<instrument::Event>(i))] = perIteration(*delta[i]);
+        }
+
+        auto &cycles = delta[static_cast<std::size_t>(instrument::Event::cycles)];
+        auto &instructions = delta[static_cast<std::size_t>(instrument::Event::instructions)];
+        if (cycles && instructions && *cycles > 0) {
+            // summed over threads, so average it per thread
+            state_.counters["IPC"] = benchmark::Counter(*instructions / *cycles, benchmark::Counter::kAvgThreads);
+        }
+#endif
+    }
+
+private:
+    benchmark::State &state_;
+    bool stopped_ = false;
+#ifdef LEETCODE_INSTRUMENT
+    instrument::PerfCounters perf_;
+    std::optional<std::uint64_t> start_[instrument::num_events];
+    instrument::AllocationStats allocations_;
+#endif
+};
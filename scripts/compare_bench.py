@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON outputs (e.g. from the bench_json target).
+
+Prints the change in time for every benchmark present in both files, as a
+percentage of the old time, and optionally fails if anything regressed by
+more than a threshold.
+
+With --noise, a second run of the old binary is used to estimate how much
+each benchmark varies between runs on its own. Changes smaller than twice
+that (and smaller than --min-change) are shown as "~", no significant
+change, and don't count as regressions.
+
+    scripts/compare_bench.py old.json new.json [--metric cpu_time] [--fail-above 5]
+    scripts/compare_bench.py old.json new.json --noise old-rerun.json
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    """Map benchmark name -> time in ns, using the median when there are repetitions."""
+    with open(path) as f:
+        data = json.load(f)
+
+    times = {}
+    medians = {}
+    for bench in data["benchmarks"]:
+        # complexity fits (_BigO, _RMS) don't have times
+        if bench.get("error_occurred") or metric not in bench:
+            continue
+        value = bench[metric] * TO_NS[bench.get("time_unit", "ns")]
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[bench["run_name"]] = value
+        else:
+            times.setdefault(bench.get("run_name", bench["name"]), []).append(value)
+
+    result = {name: statistics.median(values) for name, values in times.items()}
+    result.update(medians)
+    return result
+
+
+def format_ns(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3g} {unit}"
+    return f"{ns:.3g} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("old")
+    parser.add_argument("new")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"), default="real_time")
+    parser.add_argument("--fail-above", type=float, metavar="PERCENT",
+                        help="exit with status 1 if any benchmark got slower by more than PERCENT")
+    parser.add_argument("--noise", metavar="RERUN",
+                        help="another run of the old binary, to tell real changes from noise")
+    parser.add_argument("--min-change", type=float, default=5.0, metavar="PERCENT",
+                        help="with --noise, changes up to PERCENT are never significant (default 5)")
+    args = parser.parse_args()
+
+    old = load(args.old, args.metric)
+    new = load(args.new, args.metric)
+    rerun = load(args.noise, args.metric) if args.noise else None
+    common = [name for name in old if name in new]
+    if not common:
+        print("no benchmarks in common", file=sys.stderr)
+        return 1
+
+    width = max(len(name) for name in common)
+    print(f"{'benchmark':<{width}}  {'old':>10}  {'new':>10}  {'change':>8}")
+    regressions = []
+    for name in common:
+        change = (new[name] - old[name]) / old[name] * 100.0
+        significant = True
+        if rerun is not None and name in rerun:
+            noise = abs(rerun[name] - old[name]) / old[name] * 100.0
+            significant = abs(change) > max(2.0 * noise, args.min_change)
+        shown = f"{change:>+7.1f}%" if significant else f"{'~':>8}"
+        print(f"{name:<{width}}  {format_ns(old[name]):>10}  {format_ns(new[name]):>10}  {shown}")
+        if significant and args.fail_above is not None and change > args.fail_above:
+            regressions.append(name)
+
+    for name in sorted(set(old) ^ set(new)):
+        print(f"{name:<{width}}  only in {'old' if name in old else 'new'}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower by more than {args.fail_above}%", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,190 +1,270 @@
-#include <unordered_map>
-#include <gtest/gtest.h>
-
-class LRUCache {
-public:
-    explicit LRUCache(std::size_t capacity) :
-            capacity_(capacity),
-            cache_(),
-            oldest_(nullptr),
-            newest_(nullptr)
-    {
-        cache_.reserve(capacity_);
+#include "problems/146.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+int LRUCache::get(int key) {
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        update(it->second);
+        return it->second.value_;
+    } else {
+        return -1;
     }
+}
+
+void LRUCache::put(int key, int value) {
+    // early exit for empty case
+    if (capacity_ == 0) { return; }
 
-    /// @return The value of key if it exists, otherwise -1.
-    int get(int key) {
-        auto it = cache_.find(key);
-        if (it != cache_.end()) {
-            update(it->second);
-            return it->second.value_;
-        } else {
-            return -1;
+    // first just search for the key, note that we can't really
+    // use unordered_map::insert_or_assign here because we need
+    // the old entry
+    auto it = cache_.find(key);
+
+    if (it != cache_.end()) {
+        update(it->second, value);
+    } else {
+        // check if we're going to go over capacity
+        if (cache_.size() + 1 > capacity_) {
+            evict_oldest();
         }
+
+        // add it
+        insert_newest(key, value);
     }
+}
 
-    void put(int key, int value) {
-        // early exit for empty case
-        if (capacity_ == 0) { return; }
-
-        // first just search for the key, note that we can't really
-        // use unordered_map::insert_or_assign here because we need
-        // the old entry
-        auto it = cache_.find(key);
-
-        if (it != cache_.end()) {
-            update(it->second, value);
-        } else {
-            // check if we're going to go over capacity
-            if (cache_.size() + 1 > capacity_) {
-                evict_oldest();
-            }
+void LRUCache::update(Entry &entry, std::optional<int> value) {
+    // early exit if this is already the newest entry,
+    // this also takes care of the single-entry case
+    if (&entry == newest_) {
+        if (value) { entry.value_ = *value; }
+        return;
+    }
+
+    // update the oldest entry if needed
+    if (&entry == oldest_) { oldest_ = entry.next_; }
+    // re-direct old links
+    entry.unlink();
+    // set new links
+    entry.prev_ = newest_;
+    entry.next_ = nullptr;
+    if (value) { entry.value_ = *value; }
+    entry.link();
+
+    // update newest
+    newest_ = &entry;
+}
 
-            // add it
-            insert_newest(key, value);
+void LRUCache::insert_newest(int key, int value) {
+    auto [it, inserted] = cache_.try_emplace(key, Entry{nullptr, nullptr, key, value});
+    assert(inserted);
+    if (capacity_ != 1) { it->second.prev_ = newest_; }
+    newest_ = &it->second;
+    newest_->link();
+    // if this is the first entry added or capacity is 1
+    if (!oldest_) { oldest_ = newest_; }
+}
+
+void LRUCache::evict_oldest() {
+    assert(oldest_);
+    auto new_oldest = oldest_->next_;
+    // unlink
+    oldest_->unlink();
+    cache_.erase(oldest_->key_);
+    // update oldest
+    oldest_ = new_oldest;
+}
+
+// at most half full, so that probe sequences stay short
+static std::size_t tableSize(std::size_t capacity) {
+    return std::bit_ceil(std::max<std::size_t>(8, 2 * capacity));
+}
+
+ConcurrentLRUCache::ConcurrentLRUCache(std::size_t capacity) :
+        capacity_(capacity),
+        mask_(tableSize(capacity) - 1),
+        shift_(64 - static_cast<unsigned>(std::countr_zero(tableSize(capacity)))),
+        slots_(std::make_unique<Slot[]>(tableSize(capacity))),
+        buffers_(std::make_unique<ReadBuffer[]>(num_buffers)),
+        policy_(capacity)
+{
+    for (std::size_t i = 0; i < num_buffers; ++i) {
+        for (auto &key : buffers_[i].keys_) {
+            key.store(no_key, std::memory_order_relaxed);
         }
     }
+}
 
-private:
-    struct Entry {
-        Entry *prev_;
-        Entry *next_;
-        const int key_;
-        int value_;
+int ConcurrentLRUCache::get(int key) {
+    auto value = find(key);
+    if (!value) { return -1; }
+    record(key);
+    return *value;
+}
+
+void ConcurrentLRUCache::put(int key, int value) {
+    if (capacity_ == 0) { return; }
+
+    std::lock_guard lock(mutex_);
+    // the policy has to know about earlier reads before deciding what to evict
+    drainLocked();
 
-        void unlink() const {
-            if (prev_) { prev_->next_ = next_; }
-            if (next_) { next_->prev_ = prev_; }
+    if (auto *slot = findSlot(key)) {
+        slot->entry_.store(pack(key, value), std::memory_order_release);
+    } else {
+        if (policy_.size() == capacity_) {
+            findSlot(*policy_.oldest())->state_.store(tombstone, std::memory_order_release);
         }
+        insert(key, value);
+    }
+    policy_.put(key, value);
+}
 
-        void link() {
-            if (prev_) { prev_->next_ = this; }
-            if (next_) { next_->prev_ = this; }
+void ConcurrentLRUCache::drain() {
+    std::lock_guard lock(mutex_);
+    drainLocked();
+}
+
+std::optional<int> ConcurrentLRUCache::find(int key) const {
+    while (true) {
+        auto sequence = sequence_.load(std::memory_order_acquire);
+        if (sequence % 2 == 1) {
+            std::this_thread::yield();
+            continue;
         }
-    };
-
-    void update(Entry &entry, std::optional<int> value = std::nullopt) {
-        // early exit if this is already the newest entry,
-        // this also takes care of the single-entry case
-        if (&entry == newest_) {
-            if (value) { entry.value_ = *value; }
-            return;
+
+        // writers only ever change one slot at a time outside of rebuilds,
+        // and entries are read as a whole, so the worst that can happen is
+        // missing a concurrent put or seeing a concurrently evicted entry
+        std::optional<int> result;
+        auto index = home(key);
+        for (std::size_t probes = 0; probes <= mask_; ++probes, index = (index + 1) & mask_) {
+            auto state = slots_[index].state_.load(std::memory_order_acquire);
+            if (state == empty) { break; }
+            if (state == full) {
+                auto entry = slots_[index].entry_.load(std::memory_order_acquire);
+                if (keyOf(entry) == key) {
+                    result = valueOf(entry);
+                    break;
+                }
+            }
         }
 
-        // update the oldest entry if needed
-        if (&entry == oldest_) { oldest_ = entry.next_; }
-        // re-direct old links
-        entry.unlink();
-        // set new links
-        entry.prev_ = newest_;
-        entry.next_ = nullptr;
-        if (value) { entry.value_ = *value; }
-        entry.link();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == sequence) {
+            return result;
+        }
+    }
+}
 
-        // update newest
-        newest_ = &entry;
+void ConcurrentLRUCache::record(int key) {
+    // threads are spread over the buffers round-robin, each keeps its buffer
+    static std::atomic<std::size_t> next_buffer = 0;
+    thread_local std::size_t buffer_index = next_buffer.fetch_add(1, std::memory_order_relaxed) % num_buffers;
+    auto &buffer = buffers_[buffer_index];
+
+    // tail first, the head can only have moved further since
+    auto tail = buffer.tail_.load(std::memory_order_acquire);
+    auto head = buffer.head_.load(std::memory_order_relaxed);
+    auto pending = head - tail;
+    // lossy, the read just isn't recorded if the buffer is full or another
+    // reader got the slot first
+    if (pending < buffer_size
+        && buffer.head_.compare_exchange_strong(head, head + 1, std::memory_order_relaxed)) {
+        buffer.keys_[head % buffer_size].store(key, std::memory_order_release);
+        pending += 1;
     }
 
-    void insert_newest(int key, int value) {
-        auto [it, inserted] = cache_.try_emplace(key, Entry{nullptr, nullptr, key, value});
-        assert(inserted);
-        if (capacity_ != 1) { it->second.prev_ = newest_; }
-        newest_ = &it->second;
-        newest_->link();
-        // if this is the first entry added or capacity is 1
-        if (!oldest_) { oldest_ = newest_; }
+    if (pending >= buffer_size / 2) {
+        tryDrain();
     }
+}
+
+void ConcurrentLRUCache::tryDrain() {
+    // somebody else is already draining or writing, which also drains
+    if (!mutex_.try_lock()) { return; }
+    std::lock_guard lock(mutex_, std::adopt_lock);
+    drainLocked();
+}
 
-    void evict_oldest() {
-        assert(oldest_);
-        auto new_oldest = oldest_->next_;
-        // unlink
-        oldest_->unlink();
-        cache_.erase(oldest_->key_);
-        // update oldest
-        oldest_ = new_oldest;
+void ConcurrentLRUCache::drainLocked() {
+    for (std::size_t i = 0; i < num_buffers; ++i) {
+        auto &buffer = buffers_[i];
+        auto tail = buffer.tail_.load(std::memory_order_relaxed);
+        auto head = buffer.head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            auto key = buffer.keys_[tail % buffer_size].exchange(no_key, std::memory_order_acquire);
+            // claimed by a reader that hasn't written it yet, pick it up next time
+            if (key == no_key) { break; }
+            // just moves the key to the front, or does nothing if it was evicted since
+            policy_.get(static_cast<int>(key));
+        }
+        buffer.tail_.store(tail, std::memory_order_release);
     }
+}
 
-    const std::size_t capacity_;
-    std::unordered_map<int, Entry> cache_;
-    Entry* newest_ = nullptr;
-    Entry* oldest_ = nullptr;
-};
-
-TEST(Solution, LRUCache) {
-    // capacity = 4
-    {
-        LRUCache cache(4);
-        cache.put(1, 1);
-        cache.put(2, 2);
-        cache.put(3, 3);
-        cache.put(4, 4);
-
-        EXPECT_EQ(cache.get(2), 2);
-        EXPECT_EQ(cache.get(3), 3);
-        cache.put(5, 5);
-        EXPECT_EQ(cache.get(1), -1);
-        cache.put(6, 6);
-        EXPECT_EQ(cache.get(4), -1);
-        EXPECT_EQ(cache.get(2), 2);
-        cache.put(7, 7);
-        EXPECT_EQ(cache.get(3), -1);
-        cache.put(7, 7);
-        cache.put(7, 5);
-        EXPECT_EQ(cache.get(7), 5);
-        cache.put(7, 7);
-        EXPECT_EQ(cache.get(7), 7);
-        EXPECT_EQ(cache.get(6), 6);
-        EXPECT_EQ(cache.get(5), 5);
-        EXPECT_EQ(cache.get(2), 2);
+ConcurrentLRUCache::Slot *ConcurrentLRUCache::findSlot(int key) {
+    auto index = home(key);
+    for (std::size_t probes = 0; probes <= mask_; ++probes, index = (index + 1) & mask_) {
+        auto &slot = slots_[index];
+        auto state = slot.state_.load(std::memory_order_relaxed);
+        if (state == empty) { return nullptr; }
+        if (state == full && keyOf(slot.entry_.load(std::memory_order_relaxed)) == key) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void ConcurrentLRUCache::insert(int key, int value) {
+    auto index = home(key);
+    while (slots_[index].state_.load(std::memory_order_relaxed) == full) {
+        index = (index + 1) & mask_;
     }
 
-    // capacity = 2
-    {
-        LRUCache cache(2);
-        cache.put(1, 1);
-        cache.put(2, 2);
-        EXPECT_EQ(cache.get(1), 1);
-        cache.put(3, 3);
-        EXPECT_EQ(cache.get(2), -1);
-        cache.put(4, 4);
-        EXPECT_EQ(cache.get(1), -1);
-        EXPECT_EQ(cache.get(3), 3);
-        EXPECT_EQ(cache.get(4), 4);
-        // repeat oldest & newest
-        EXPECT_EQ(cache.get(3), 3);
-        EXPECT_EQ(cache.get(3), 3);
-        cache.put(4, 44);
-        cache.put(2, 22);
-        EXPECT_EQ(cache.get(3), -1);
-        EXPECT_EQ(cache.get(4), 44);
+    auto &slot = slots_[index];
+    if (slot.state_.load(std::memory_order_relaxed) == empty) { used_ += 1; }
+    // readers skip the slot until it's marked full, so the entry has to come first
+    slot.entry_.store(pack(key, value), std::memory_order_relaxed);
+    slot.state_.store(full, std::memory_order_release);
+
+    // too many tombstones make misses probe for a long time
+    if (used_ > (mask_ + 1) / 4 * 3) {
+        rebuild();
     }
-    // capacity = 1
-    {
-        LRUCache cache(1);
-        cache.put(2, 1);
-        EXPECT_EQ(cache.get(2), 1);
-        cache.put(3, 2);
-        EXPECT_EQ(cache.get(2), -1);
-        EXPECT_EQ(cache.get(3), 2);
+}
+
+void ConcurrentLRUCache::rebuild() {
+    std::vector<std::uint64_t> entries;
+    entries.reserve(policy_.size() + 1);
+    for (std::size_t i = 0; i <= mask_; ++i) {
+        if (slots_[i].state_.load(std::memory_order_relaxed) == full) {
+            entries.push_back(slots_[i].entry_.load(std::memory_order_relaxed));
+        }
     }
-    // capacity = 1
-    {
-        LRUCache cache(1);
-        EXPECT_EQ(cache.get(1), -1);
-        cache.put(1, 1); // cache is {1=1}
-        EXPECT_EQ(cache.get(1), 1);
-        cache.put(2, 2); // cache is {2=2}
-        EXPECT_EQ(cache.get(1), -1);
-        EXPECT_EQ(cache.get(2), 2);
-        cache.put(2, 3); // cache is {2=3}
-        EXPECT_EQ(cache.get(2), 3);
+
+    // seqlock write, readers that overlap with this retry
+    auto sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i <= mask_; ++i) {
+        slots_[i].state_.store(empty, std::memory_order_relaxed);
     }
-    // capacity = 0
-    {
-        LRUCache cache(0);
-        EXPECT_EQ(cache.get(1), -1);
-        cache.put(1, 1);
-        EXPECT_EQ(cache.get(1), -1);
+    for (auto entry : entries) {
+        auto index = home(keyOf(entry));
+        while (slots_[index].state_.load(std::memory_order_relaxed) == full) {
+            index = (index + 1) & mask_;
+        }
+        slots_[index].entry_.store(entry, std::memory_order_relaxed);
+        slots_[index].state_.store(full, std::memory_order_relaxed);
     }
+    used_ = entries.size();
+
+    sequence_.store(sequence + 2, std::memory_order_release);
 }
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+class LRUCache {
+public:
+    explicit LRUCache(std::size_t capacity) :
+            capacity_(capacity),
+            cache_(),
+            oldest_(nullptr),
+            newest_(nullptr)
+    {
+        cache_.reserve(capacity_);
+    }
+
+    /// @return The value of key if it exists, otherwise -1.
+    int get(int key);
+
+    void put(int key, int value);
+
+    [[nodiscard]] std::size_t size() const {
+        return cache_.size();
+    }
+
+    /// @return The least recently used key, if there is one.
+    [[nodiscard]] std::optional<int> oldest() const {
+        return oldest_ ? std::optional(oldest_->key_) : std::nullopt;
+    }
+
+private:
+    struct Entry {
+        Entry *prev_;
+        Entry *next_;
+        const int key_;
+        int value_;
+
+        void unlink() const {
+            if (prev_) { prev_->next_ = next_; }
+            if (next_) { next_->prev_ = prev_; }
+        }
+
+        void link() {
+            if (prev_) { prev_->next_ = this; }
+            if (next_) { next_->prev_ = this; }
+        }
+    };
+
+    void update(Entry &entry, std::optional<int> value = std::nullopt);
+
+    void insert_newest(int key, int value);
+
+    void evict_oldest();
+
+    const std::size_t capacity_;
+    std::unordered_map<int, Entry> cache_;
+    Entry* newest_ = nullptr;
+    Entry* oldest_ = nullptr;
+};
+
+// LRUCache for read-heavy workloads where get() is called from many threads
+// at once. Reads don't take a lock or write to any shared entry: values are
+// looked up in an open addressing table that can be read while it's being
+// modified, and the access is recorded in one of a few lossy ring buffers
+// (in the style of Caffeine's read buffers). put(), and reads that find a
+// buffer filling up, take the lock and replay the recorded accesses on an
+// LRUCache that decides what to evict. Recency is only approximate when
+// there are concurrent readers, since accesses are dropped when a buffer
+// is full.
+class ConcurrentLRUCache {
+public:
+    explicit ConcurrentLRUCache(std::size_t capacity);
+
+    ConcurrentLRUCache(const ConcurrentLRUCache &) = delete;
+    ConcurrentLRUCache &operator=(const ConcurrentLRUCache &) = delete;
+
+    /// @return The value of key if it exists, otherwise -1.
+    int get(int key);
+
+    void put(int key, int value);
+
+    /// Applies all recorded reads now instead of when a buffer fills up.
+    void drain();
+
+private:
+    enum SlotState : std::uint8_t {
+        empty = 0,
+        full,
+        // removed, lookups have to keep probing past it
+        tombstone
+    };
+
+    struct Slot {
+        // key in the upper and value in the lower half, so that readers
+        // always see a matching pair
+        std::atomic<std::uint64_t> entry_;
+        std::atomic<std::uint8_t> state_;
+    };
+
+    static constexpr std::size_t num_buffers = 16;
+    static constexpr std::size_t buffer_size = 32;
+    // marks a buffer entry that hasn't been written yet, outside the range of int
+    static constexpr std::int64_t no_key = INT64_MIN;
+
+    // Bounded multi-producer ring buffer of read keys, only the cache's
+    // lock holder consumes from it.
+    struct alignas(64) ReadBuffer {
+        std::atomic<std::uint64_t> head_;
+        std::atomic<std::uint64_t> tail_;
+        std::atomic<std::int64_t> keys_[buffer_size];
+    };
+
+    static std::uint64_t pack(int key, int value) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(key)) << 32
+               | static_cast<std::uint32_t>(value);
+    }
+
+    static int keyOf(std::uint64_t entry) {
+        return static_cast<int>(static_cast<std::uint32_t>(entry >> 32));
+    }
+
+    static int valueOf(std::uint64_t entry) {
+        return static_cast<int>(static_cast<std::uint32_t>(entry));
+    }
+
+    [[nodiscard]] std::size_t home(int key) const {
+        return static_cast<std::size_t>((static_cast<std::uint32_t>(key) * 0x9e3779b97f4a7c15ull) >> shift_);
+    }
+
+    [[nodiscard]] std::optional<int> find(int key) const;
+    void record(int key);
+    void tryDrain();
+
+    // everything below needs the lock
+    void drainLocked();
+    Slot *findSlot(int key);
+    void insert(int key, int value);
+    void rebuild();
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    const unsigned shift_;
+    std::unique_ptr<Slot[]> slots_;
+    // full or tombstone slots
+    std::size_t used_ = 0;
+    // odd while the table is being rebuilt, readers retry if it changed
+    std::atomic<std::uint64_t> sequence_ = 0;
+    std::unique_ptr<ReadBuffer[]> buffers_;
+
+    std::mutex mutex_;
+    LRUCache policy_;
+};
@@ -1,109 +1,85 @@
-#include <memory>
-#include <stack>
-
-// Definition for a binary tree node.
-struct TreeNode {
-    std::unique_ptr<TreeNode> left;
-    std::unique_ptr<TreeNode> right;
-    int val;
-
-    TreeNode(int x) : val(x), left(nullptr), right(nullptr) {}
-    TreeNode(TreeNode &&left, int x, TreeNode &&right) :
-            val(x),
-            left(std::make_unique<TreeNode>(std::move(left))),
-            right(std::make_unique<TreeNode>(std::move(right))) {}
-
-    TreeNode(int x, TreeNode &&right) :
-            val(x),
-            left(),
-            right(std::make_unique<TreeNode>(std::move(right))) {}
-
-    TreeNode(TreeNode &&left, int x) :
-            val(x),
-            left(std::make_unique<TreeNode>(std::move(left))),
-            right() {}
-};
-
-class BSTIterator {
-public:
-    explicit BSTIterator(TreeNode* root) {
-        stack_.emplace(*root);
-        nextLeaf();
-    }
-
-    int next() {
-        auto &top = stack_.top();
-        auto value = top.node_->val;
-        top.visited_ = true;
-
-        if (top.node_->right) {
-            stack_.emplace(*top.node_->right);
-            nextLeaf();
+#include "problems/173.h"
+
+int OrderStatisticBST::nth(std::size_t k) const {
+    auto *node = root_.get();
+    while (true) {
+        auto left_size = sizeOf(node->left);
+        if (k < left_size) {
+            node = node->left.get();
+        } else if (k == left_size) {
+            return node->val;
         } else {
-            stack_.pop();
-            nextNode();
+            k -= left_size + 1;
+            node = node->right.get();
         }
-
-        return value;
-    }
-
-    [[nodiscard]] bool hasNext() const {
-        return !stack_.empty();
-    }
-
-private:
-    void nextLeaf() {
-        do {
-            auto &top = *stack_.top().node_;
-            if (top.left) {
-                stack_.emplace(*top.left);
-            } else {
-                // continue until we get to a node with no left child
-                break;
-            }
-        } while (true);
     }
+}
 
-    void nextNode() {
-        while (!stack_.empty() && stack_.top().visited_) {
-            stack_.pop();
+std::size_t OrderStatisticBST::rank(int key) const {
+    std::size_t rank = 0;
+    auto *node = root_.get();
+    while (node) {
+        if (node->val < key) {
+            rank += sizeOf(node->left) + 1;
+            node = node->right.get();
+        } else {
+            node = node->left.get();
         }
     }
+    return rank;
+}
 
-    struct NodeIter {
-        explicit NodeIter(TreeNode &node) : node_(&node) {}
-
-        TreeNode *node_;
-        bool visited_ = false;
-    };
-
-    std::stack<NodeIter> stack_;
-};
+std::unique_ptr<SizedTreeNode> OrderStatisticBST::copy(const TreeNode *node) {
+    if (!node) { return nullptr; }
 
-#include <gtest/gtest.h>
+    auto left = copy(node->left.get());
+    auto right = copy(node->right.get());
+    auto size = sizeOf(left) + sizeOf(right) + 1;
+    return std::make_unique<SizedTreeNode>(SizedTreeNode{std::move(left), std::move(right), node->val, size});
+}
 
-TEST(Solution, BSTIterator) {
-    using TN = TreeNode;
-    auto check = [](TreeNode node, int num_expected) {
-        std::vector<int> actual;
-        std::vector<int> expected;
+ThreadedBST::ThreadedBST(const TreeNode* root) : nodes_(), first_(nullptr) {
+    if (!root) { return; }
+
+    // count first so that node addresses are stable while linking
+    std::size_t num_nodes = 0;
+    std::vector<const TreeNode *> pending = {root};
+    while (!pending.empty()) {
+        auto *node = pending.back();
+        pending.pop_back();
+        num_nodes += 1;
+        if (node->right) { pending.push_back(node->right.get()); }
+        if (node->left) { pending.push_back(node->left.get()); }
+    }
+    nodes_.reserve(num_nodes);
+
+    // copy in pre-order, filling in child links as we go
+    std::vector<std::pair<const TreeNode *, Node **>> copy = {{root, nullptr}};
+    while (!copy.empty()) {
+        auto [node, link] = copy.back();
+        copy.pop_back();
+
+        auto &copied = nodes_.emplace_back();
+        copied.val_ = node->val;
+        if (link) { *link = &copied; }
+        if (node->right) { copy.emplace_back(node->right.get(), &copied.right_); }
+        if (node->left) { copy.emplace_back(node->left.get(), &copied.left_); }
+    }
 
-        auto iter = BSTIterator(&node);
-        for (int i = 1; i <= num_expected; ++i) {
-            expected.push_back(i);
-            if (iter.hasNext()) {
-                actual.push_back(iter.next());
-            }
+    // thread the copy in-order
+    Node *prev = nullptr;
+    std::vector<Node *> stack;
+    auto *current = &nodes_.front();
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left_;
         }
+        current = stack.back();
+        stack.pop_back();
 
-        EXPECT_EQ(actual, expected);
-        EXPECT_FALSE(iter.hasNext());
-    };
-
-    check(TN(1), 1);
-    check(TN(TN(1), 2, TN(3)), 3);
-    check(TN(TN(TN(1), 2), 3), 3);
-    check(TN(1, TN(2, TN(3))), 3);
-    check(TN(TN(1, TN(2)), 3, TN(TN(4), 5)), 5);
-    check(TN(TN(TN(1), 2, TN(3)), 4, TN(TN(5), 6, TN(7))), 7);
+        if (prev) { prev->next_ = current; } else { first_ = current; }
+        prev = current;
+        current = current->right_;
+    }
 }
@@ -0,0 +1,496 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stack>
+#include <vector>
+
+// Definition for a binary tree node.
+struct TreeNode {
+    std::unique_ptr<TreeNode> left;
+    std::unique_ptr<TreeNode> right;
+    int val;
+
+    TreeNode(int x) : val(x), left(nullptr), right(nullptr) {}
+    TreeNode(TreeNode &&left, int x, TreeNode &&right) :
+            val(x),
+            left(std::make_unique<TreeNode>(std::move(left))),
+            right(std::make_unique<TreeNode>(std::move(right))) {}
+
+    TreeNode(int x, TreeNode &&right) :
+            val(x),
+            left(),
+            right(std::make_unique<TreeNode>(std::move(right))) {}
+
+    TreeNode(TreeNode &&left, int x) :
+            val(x),
+            left(std::make_unique<TreeNode>(std::move(left))),
+            right() {}
+};
+
+// In-order iterator over a BST, in descending order if `Reverse` is set.
+template<bool Reverse>
+class BasicBSTIterator {
+public:
+    explicit BasicBSTIterator(TreeNode* root) : root_(root) {
+        stack_.emplace(*root);
+        nextLeaf();
+    }
+
+    int next() {
+        auto &top = stack_.top();
+        auto value = top.node_->val;
+        top.visited_ = true;
+
+        if (far(*top.node_)) {
+            stack_.emplace(*far(*top.node_));
+            nextLeaf();
+        } else {
+            stack_.pop();
+            nextNode();
+        }
+
+        return value;
+    }
+
+    [[nodiscard]] bool hasNext() const {
+        return !stack_.empty();
+    }
+
+    // Repositions the iterator in O(h) so that next() returns the first key
+    // not less than `key` (not greater than, if iterating in reverse).
+    void seek(int key) {
+        stack_ = {};
+
+        auto *node = root_;
+        while (node) {
+            if (Reverse ? node->val <= key : node->val >= key) {
+                // this node comes after everything in its near subtree, so
+                // it's only next if nothing there matches
+                stack_.emplace(*node);
+                node = near(*node);
+            } else {
+                node = far(*node);
+            }
+        }
+    }
+
+private:
+    // the child visited first, left when iterating in ascending order
+    static TreeNode *near(const TreeNode &node) {
+        return Reverse ? node.right.get() : node.left.get();
+    }
+
+    static TreeNode *far(const TreeNode &node) {
+        return Reverse ? node.left.get() : node.right.get();
+    }
+
+    void nextLeaf() {
+        do {
+            auto &top = *stack_.top().node_;
+            if (near(top)) {
+                stack_.emplace(*near(top));
+            } else {
+                // continue until we get to a node with no near child
+                break;
+            }
+        } while (true);
+    }
+
+    void nextNode() {
+        while (!stack_.empty() && stack_.top().visited_) {
+            stack_.pop();
+        }
+    }
+
+    struct NodeIter {
+        explicit NodeIter(TreeNode &node) : node_(&node) {}
+
+        TreeNode *node_;
+        bool visited_ = false;
+    };
+
+    TreeNode *root_;
+    std::stack<NodeIter> stack_;
+};
+
+using BSTIterator = BasicBSTIterator<false>;
+using ReverseBSTIterator = BasicBSTIterator<true>;
+
+// TreeNode augmented with the size of its subtree.
+struct SizedTreeNode {
+    std::unique_ptr<SizedTreeNode> left;
+    std::unique_ptr<SizedTreeNode> right;
+    int val;
+    std::size_t size;
+};
+
+// Copy of a BST with subtree sizes, so that order statistics only take
+// a single walk down the tree (O(log n) when balanced) instead of an
+// in-order scan.
+class OrderStatisticBST {
+public:
+    explicit OrderStatisticBST(const TreeNode *root) : root_(copy(root)) {}
+
+    [[nodiscard]] std::size_t size() const {
+        return sizeOf(root_);
+    }
+
+    // @return The k-th smallest key, counting from 0. The result is
+    //         undefined if k >= size().
+    [[nodiscard]] int nth(std::size_t k) const;
+
+    // @return The number of keys less than `key`.
+    [[nodiscard]] std::size_t rank(int key) const;
+
+private:
+    static std::size_t sizeOf(const std::unique_ptr<SizedTreeNode> &node) {
+        return node ? node->size : 0;
+    }
+
+    static std::unique_ptr<SizedTreeNode> copy(const TreeNode *node);
+
+    std::unique_ptr<SizedTreeNode> root_;
+};
+
+// Alternative to BSTIterator using O(1) extra memory via Morris traversal.
+// Before descending into a left subtree, the right link of the subtree's
+// rightmost node (the in-order predecessor) is pointed back at the current
+// node so we can find our way back up, and the link is removed again on
+// the way back. The tree is only back to normal once the traversal is
+// finished, so the destructor finishes it if the iterator is dropped early.
+//
+// The tree must outlive the iterator, and nothing else may read it while
+// the iterator exists: the temporary links are unique_ptrs, so destroying
+// the tree first would free nodes twice, and other readers would see cycles.
+class MorrisBSTIterator {
+public:
+    explicit MorrisBSTIterator(TreeNode* root) : current_(root), next_(nullptr) {
+        advance();
+    }
+
+    MorrisBSTIterator(const MorrisBSTIterator &) = delete;
+    MorrisBSTIterator &operator=(const MorrisBSTIterator &) = delete;
+
+    ~MorrisBSTIterator() {
+        while (hasNext()) {
+            next();
+        }
+    }
+
+    int next() {
+        auto value = next_->val;
+        // note that this may be a temporary link back up the tree
+        current_ = next_->right.get();
+        advance();
+
+        return value;
+    }
+
+    [[nodiscard]] bool hasNext() const {
+        return next_ != nullptr;
+    }
+
+private:
+    void advance() {
+        while (current_) {
+            if (!current_->left) {
+                next_ = current_;
+                return;
+            }
+
+            // find the in-order predecessor of current_
+            auto *pred = current_->left.get();
+            while (pred->right && pred->right.get() != current_) {
+                pred = pred->right.get();
+            }
+
+            if (!pred->right) {
+                // first visit, link back to current_ and go left
+                pred->right.reset(current_);
+                current_ = current_->left.get();
+            } else {
+                // second visit, the left subtree is done so remove the link
+                // (without deleting current_, which we don't own through it)
+                static_cast<void>(pred->right.release());
+                next_ = current_;
+                return;
+            }
+        }
+        next_ = nullptr;
+    }
+
+    TreeNode *current_;
+    TreeNode *next_;
+};
+
+// Read-only copy of a tree where every node also points at its in-order
+// successor, so iterating over it is a single pointer hop per element.
+class ThreadedBST {
+public:
+    // Links are only writable by ThreadedBST itself while threading the
+    // copy, everyone else gets them as const.
+    class Node {
+    public:
+        [[nodiscard]] const Node *left() const { return left_; }
+        [[nodiscard]] const Node *right() const { return right_; }
+
+        // @return The in-order successor, null for the last node.
+        [[nodiscard]] const Node *next() const { return next_; }
+
+        [[nodiscard]] int val() const { return val_; }
+
+    private:
+        friend class ThreadedBST;
+
+        Node *left_ = nullptr;
+        Node *right_ = nullptr;
+        Node *next_ = nullptr;
+        int val_ = 0;
+    };
+
+    explicit ThreadedBST(const TreeNode* root);
+
+    // @return The root of the tree, null if empty.
+    [[nodiscard]] const Node *root() const {
+        return nodes_.empty() ? nullptr : &nodes_.front();
+    }
+
+    // @return The node with the smallest value, null if empty.
+    [[nodiscard]] const Node *first() const {
+        return first_;
+    }
+
+private:
+    std::vector<Node> nodes_;
+    Node *first_;
+};
+
+class ThreadedBSTIterator {
+public:
+    explicit ThreadedBSTIterator(const ThreadedBST &tree) : current_(tree.first()) {}
+
+    int next() {
+        auto value = current_->val();
+        current_ = current_->next();
+        return value;
+    }
+
+    [[nodiscard]] bool hasNext() const {
+        return current_ != nullptr;
+    }
+
+private:
+    const ThreadedBST::Node *current_;
+};
+
+// Memory layouts for FrozenBST. Both store a perfect binary tree of the
+// given height implicitly, nodes are identified by their depth (root is 0)
+// and their path from the root (one bit per level, 1 for right).
+//
+// Breadth-first layout, with slot 0 left empty so that the children of
+// slot k are at 2k and 2k + 1.
+struct EytzingerLayout {
+    static std::size_t position(unsigned, unsigned depth, std::size_t path) {
+        return (std::size_t(1) << depth) + path;
+    }
+
+    // Branch-free lower_bound descent.
+    // @return The path taken through all `height` levels with a leading 1 bit.
+    static std::size_t descend(const int *keys, unsigned height, std::size_t capacity, int key) {
+        std::size_t k = 1;
+        for (unsigned depth = 0; depth < height; ++depth) {
+            // the 16 descendants 4 levels down share a cache line
+            __builtin_prefetch(keys + std::min(16 * k, capacity - 1));
+            k = 2 * k + (keys[k] < key);
+        }
+        return k;
+    }
+};
+
+// Van Emde Boas layout, the tree is split into a top half and the bottom
+// subtrees hanging off of it, each of which is stored contiguously (top
+// first) and laid out the same way recursively. Any root-to-leaf path then
+// touches O(log_B n) cache lines for every cache line size B.
+struct VanEmdeBoasLayout {
+    static std::size_t position(unsigned height, unsigned depth, std::size_t path) {
+        std::size_t offset = 0;
+        while (height > 1) {
+            unsigned bottom = height / 2;
+            unsigned top = height - bottom;
+            if (depth < top) {
+                height = top;
+                continue;
+            }
+
+            // skip the top tree and the bottom trees before ours
+            depth -= top;
+            auto subtree = path >> depth;
+            path &= (std::size_t(1) << depth) - 1;
+            offset += ((std::size_t(1) << top) - 1) + subtree * ((std::size_t(1) << bottom) - 1);
+            height = bottom;
+        }
+        return offset;
+    }
+
+    static std::size_t descend(const int *keys, unsigned height, std::size_t, int key) {
+        if (height == 0) { return 1; }
+        return (std::size_t(1) << height) | descendSubtree(keys, height, key);
+    }
+
+private:
+    // @return The path taken through the subtree rooted at `keys`.
+    static std::size_t descendSubtree(const int *keys, unsigned height, int key) {
+        if (height == 1) {
+            return keys[0] < key;
+        }
+
+        unsigned bottom = height / 2;
+        unsigned top = height - bottom;
+        auto top_path = descendSubtree(keys, top, key);
+        auto *subtree = keys + ((std::size_t(1) << top) - 1) + top_path * ((std::size_t(1) << bottom) - 1);
+        return (top_path << bottom) | descendSubtree(subtree, bottom, key);
+    }
+};
+
+// Read-only search tree frozen into one contiguous, pointer-free array for
+// read-mostly indexes. Keys are addressed by their in-order rank, where
+// rank size() is the end.
+template<class Layout>
+class FrozenBST {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int *;
+        using reference = const int &;
+
+        const_iterator() = default;
+        const_iterator(const FrozenBST *tree, std::size_t rank) : tree_(tree), rank_(rank) {}
+
+        reference operator*() const { return (*tree_)[rank_]; }
+        pointer operator->() const { return &(*tree_)[rank_]; }
+
+        const_iterator &operator++() {
+            ++rank_;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto old = *this;
+            ++rank_;
+            return old;
+        }
+
+        bool operator==(const const_iterator &other) const { return rank_ == other.rank_; }
+        bool operator!=(const const_iterator &other) const { return rank_ != other.rank_; }
+
+        [[nodiscard]] std::size_t rank() const { return rank_; }
+
+    private:
+        const FrozenBST *tree_ = nullptr;
+        std::size_t rank_ = 0;
+    };
+
+    explicit FrozenBST(const TreeNode *root) : FrozenBST(inOrder(root)) {}
+
+    // @param sorted Keys in non-decreasing order.
+    explicit FrozenBST(const std::vector<int> &sorted) :
+            size_(sorted.size()),
+            height_(heightFor(sorted.size())),
+            capacity_(std::size_t(1) << height_),
+            keys_(allocate(capacity_))
+    {
+        // unused slots are padded with the largest possible key, since they come
+        // after every real key in-order, lowerBound() still finds real keys first
+        keys_[0] = INT_MAX;
+        for (std::size_t rank = 0; rank + 1 < capacity_; ++rank) {
+            keys_[position(rank)] = rank < size_ ? sorted[rank] : INT_MAX;
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+    const int &operator[](std::size_t rank) const {
+        return keys_[position(rank)];
+    }
+
+    // @return The rank of the first key not less than `key`, or size() if there is none.
+    [[nodiscard]] std::size_t lowerBound(int key) const {
+        auto k = Layout::descend(keys_.get(), height_, capacity_, key);
+        // the last time we went left is the answer, so strip off the
+        // trailing right turns and the left turn itself
+        k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+        if (k == 0) { return size_; }
+
+        auto depth = static_cast<unsigned>(63 - __builtin_clzll(k));
+        auto path = k - (std::size_t(1) << depth);
+        auto rank = ((2 * path + 1) << (height_ - 1 - depth)) - 1;
+        return std::min(rank, size_);
+    }
+
+    [[nodiscard]] const_iterator lower_bound(int key) const { return {this, lowerBound(key)}; }
+    [[nodiscard]] const_iterator begin() const { return {this, 0}; }
+    [[nodiscard]] const_iterator end() const { return {this, size_}; }
+
+    // Calls `f` with every key in [low, high) in order.
+    template<class F>
+    void scan(int low, int high, F &&f) const {
+        for (auto rank = lowerBound(low); rank < size_; ++rank) {
+            auto key = (*this)[rank];
+            if (key >= high) { break; }
+            f(key);
+        }
+    }
+
+private:
+    struct AlignedDelete {
+        void operator()(int *keys) const { ::operator delete[](keys, std::align_val_t(64)); }
+    };
+
+    static std::unique_ptr<int[], AlignedDelete> allocate(std::size_t n) {
+        auto *memory = ::operator new[](n * sizeof(int), std::align_val_t(64));
+        return std::unique_ptr<int[], AlignedDelete>(static_cast<int *>(memory));
+    }
+
+    static unsigned heightFor(std::size_t n) {
+        unsigned height = 0;
+        while ((std::size_t(1) << height) - 1 < n) {
+            height += 1;
+        }
+        return height;
+    }
+
+    static std::vector<int> inOrder(const TreeNode *root) {
+        std::vector<int> keys;
+        std::vector<const TreeNode *> stack;
+        while (root || !stack.empty()) {
+            while (root) {
+                stack.push_back(root);
+                root = root->left.get();
+            }
+            keys.push_back(stack.back()->val);
+            root = stack.back()->right.get();
+            stack.pop_back();
+        }
+        return keys;
+    }
+
+    [[nodiscard]] std::size_t position(std::size_t rank) const {
+        // in a perfect tree, rank + 1 is (2 * path + 1) << (height - 1 - depth)
+        auto zeros = static_cast<unsigned>(__builtin_ctzll(rank + 1));
+        return Layout::position(height_, height_ - 1 - zeros, (rank + 1) >> (zeros + 1));
+    }
+
+    std::size_t size_;
+    unsigned height_;
+    std::size_t capacity_;
+    std::unique_ptr<int[], AlignedDelete> keys_;
+};
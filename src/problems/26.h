@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// https://leetcode.com/explore/interview/card/top-interview-questions-easy/92/array/727/
+class Solution {
+public:
+    static std::size_t removeDuplicates(std::vector<int>& nums);
+};
@@ -1,41 +1,77 @@
-#include <gtest/gtest.h>
+#include "problems/278.h"
 
-class Solution {
-public:
-    template<class F>
-    static int firstBadVersion(int n, F &&isBadVersion) {
-        int low = 1;
-        int high = n;
+#include <algorithm>
 
+namespace search {
+    void lowerBoundBatch(std::span<const int> data, std::span<const int> keys,
+                         std::span<std::size_t> out) {
+        constexpr std::size_t batch_size = 16;
+        assert(out.size() >= keys.size());
+
+        for (std::size_t first = 0; first < keys.size(); first += batch_size) {
+            auto count = std::min(batch_size, keys.size() - first);
+            const int *bases[batch_size];
+            std::fill(bases, bases + count, data.data());
+
+            // every search in the batch shrinks the range the same way
+            auto len = data.size();
+            while (len > 1) {
+                auto half = len / 2;
+                auto next_half = (len - half) / 2;
+                for (std::size_t i = 0; i < count; ++i) {
+                    bases[i] += static_cast<std::size_t>(bases[i][half] < keys[first + i]) * half;
+                    __builtin_prefetch(bases[i] + next_half);
+                }
+                len -= half;
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                auto offset = static_cast<std::size_t>(bases[i] - data.data());
+                out[first + i] = data.empty() ? 0 : offset + (*bases[i] < keys[first + i]);
+            }
+        }
+    }
+
+    std::size_t interpolationLowerBound(std::span<const int> data, int key) {
+        std::size_t low = 0;
+        std::size_t high = data.size();
+        bool bisect = false;
+
+        // the answer is always in [low, high]
         while (low < high) {
-            int mid = (high - low) / 2 + low;
-            if (isBadVersion(mid)) {
-                // first bad version is in [low, mid]
-                high = mid;
+            if (key <= data[low]) { return low; }
+            if (key > data[high - 1]) { return high; }
+
+            // data[low] < key <= data[high - 1], so the span is positive
+            std::size_t probe;
+            if (bisect) {
+                probe = low + (high - low) / 2;
             } else {
-                // first bad version is in (mid, high]
-                low = mid + 1;
+                auto fraction = (static_cast<double>(key) - data[low])
+                                / (static_cast<double>(data[high - 1]) - data[low]);
+                probe = low + static_cast<std::size_t>(fraction * static_cast<double>(high - 1 - low));
             }
-        }
 
-        return high;
+            auto old_len = high - low;
+            if (data[probe] < key) {
+                low = probe + 1;
+            } else {
+                high = probe;
+            }
+            bisect = high - low > old_len / 2;
+        }
+        return low;
     }
 
-    static void test(int n, int bad) {
-        auto isBad = [bad](int m) { return m >= bad; };
-        auto actual = firstBadVersion(n, isBad);
-        EXPECT_EQ(actual, bad);
+    std::size_t exponentialLowerBound(std::span<const int> data, int key) {
+        std::size_t bound = 1;
+        while (bound < data.size() && data[bound - 1] < key) {
+            bound *= 2;
+        }
+
+        // everything before bound / 2 is less than key
+        auto low = bound / 2;
+        auto high = std::min(bound, data.size());
+        return low + lowerBound(data.subspan(low, high - low), key);
     }
-};
-
-TEST(Solution, firstBadVersion) {
-    auto testAllN = [](int n) {
-        for (int i = 1; i < n; ++i)
-            Solution::test(n, i);
-    };
-
-    testAllN(1);
-    testAllN(5);
-    testAllN(6);
-    testAllN(12);
 }
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <type_traits>
+
+#include "util/work_stealing_pool.h"
+
+// Searches over sorted arrays and monotone predicates, generalizing the
+// binary search in Solution::firstBadVersion.
+namespace search {
+    // @return The first value in [low, high) for which `pred` is true, or
+    //         `high` if there is none. `pred` must be monotone.
+    // The number of iterations only depends on high - low, and the result
+    // of `pred` is folded into the next offset with arithmetic instead of
+    // being branched on.
+    template<class T, class Pred>
+    T firstTrue(T low, T high, Pred &&pred) {
+        if (low >= high) { return high; }
+
+        auto base = low;
+        auto len = high - low;
+        while (len > 1) {
+            auto half = len / 2;
+            base += static_cast<T>(!pred(base + half)) * half;
+            len -= half;
+        }
+        return base + static_cast<T>(!pred(base));
+    }
+
+    // Branch-free equivalent of std::lower_bound, prefetching both of the
+    // possible elements for the next iteration.
+    inline std::size_t lowerBound(std::span<const int> data, int key) {
+        if (data.empty()) { return 0; }
+
+        const int *base = data.data();
+        auto len = data.size();
+        while (len > 1) {
+            auto half = len / 2;
+            auto next_half = (len - half) / 2;
+            __builtin_prefetch(base + next_half);
+            __builtin_prefetch(base + half + next_half);
+            base += static_cast<std::size_t>(base[half] < key) * half;
+            len -= half;
+        }
+        return static_cast<std::size_t>(base - data.data()) + (*base < key);
+    }
+
+    // lowerBound() for all of `keys` at once. Searches are run in lockstep
+    // in groups of `batch_size`, so the cache misses of independent searches
+    // overlap instead of being serialized.
+    void lowerBoundBatch(std::span<const int> data, std::span<const int> keys,
+                         std::span<std::size_t> out);
+
+    // lower_bound that guesses where `key` is assuming evenly distributed
+    // values, O(log log n) probes for uniform data. Any probe that fails to
+    // at least halve the range is followed by a plain bisection step, so
+    // the worst case is still O(log n).
+    std::size_t interpolationLowerBound(std::span<const int> data, int key);
+
+    // lower_bound that checks ranges of doubling size from the front first,
+    // O(log i) for an answer at index i, which suits data where most
+    // lookups land near the head.
+    std::size_t exponentialLowerBound(std::span<const int> data, int key);
+
+    // firstTrue for predicates that are expensive to evaluate (e.g. a build
+    // and test step when bisecting), trading extra calls for fewer rounds.
+    // Each round splits the remaining range with `arity - 1` probes that run
+    // concurrently on `pool`, so it takes about log_arity(n) rounds instead
+    // of log2(n) sequential calls. Results are memoized across rounds, and
+    // probes are cancelled as soon as another result makes them irrelevant:
+    // queued ones are skipped, and running ones have their std::stop_token
+    // triggered if `pred` accepts one as a second argument.
+    //
+    // Bounds are 64-bit so that e.g. all versions [1, INT_MAX] fit, `pred`
+    // is called with a std::int64_t. If a call throws, every other probe is
+    // cancelled and the exception is rethrown once the running ones return.
+    //
+    // `pred` is called concurrently and must be thread-safe. The pool should
+    // have about `arity - 1` threads, and this must not be called from one
+    // of its workers since it blocks until the probes finish.
+    template<class Pred>
+    std::int64_t firstTrueParallel(std::int64_t low, std::int64_t high, std::size_t arity, Pred &&pred,
+                                   WorkStealingPool &pool = WorkStealingPool::global()) {
+        assert(arity >= 2);
+
+        struct Probe {
+            std::int64_t point_;
+            std::stop_source stop_;
+        };
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::map<std::int64_t, bool> known;
+        // stable addresses, since probes outlive the round that started them
+        std::deque<Probe> probes;
+        std::size_t running = 0;
+        std::exception_ptr error;
+
+        // shrink [low, high) using everything known so far
+        auto narrow = [&] {
+            for (auto it = known.lower_bound(low); it != known.end() && it->first < high; ++it) {
+                if (it->second) {
+                    high = it->first;
+                    break;
+                }
+                low = it->first + 1;
+            }
+        };
+
+        auto runProbe = [&](Probe &probe) {
+            std::optional<bool> result;
+            std::exception_ptr probe_error;
+            auto token = probe.stop_.get_token();
+
+            if (!token.stop_requested()) {
+                try {
+                    if constexpr (std::is_invocable_v<Pred &, std::int64_t, std::stop_token>) {
+                        bool value = pred(probe.point_, token);
+                        // the result of a cancelled call can't be trusted
+                        if (!token.stop_requested()) { result = value; }
+                    } else {
+                        result = pred(probe.point_);
+                    }
+                } catch (...) {
+                    probe_error = std::current_exception();
+                }
+            }
+
+            std::lock_guard guard(mutex);
+            if (result) { known.emplace(probe.point_, *result); }
+            if (probe_error && !token.stop_requested() && !error) { error = probe_error; }
+            running -= 1;
+            // notify while still holding the lock, `changed` may not outlive it otherwise
+            changed.notify_all();
+        };
+
+        std::unique_lock lock(mutex);
+        narrow();
+        while (low < high && !error) {
+            // spread probes evenly over the range, skipping known points
+            auto round_begin = probes.size();
+            auto len = high - low;
+            auto n = static_cast<std::int64_t>(arity);
+            for (std::int64_t i = 1; i < n; ++i) {
+                // len * i / n without overflowing for huge ranges
+                auto point = low + len / n * i + len % n * i / n;
+                bool duplicate = probes.size() != round_begin && probes.back().point_ == point;
+                if (!duplicate && !known.count(point)) {
+                    probes.push_back(Probe{point, {}});
+                }
+            }
+
+            for (auto i = round_begin; i < probes.size(); ++i) {
+                running += 1;
+                pool.submit([&runProbe, &probe = probes[i]] { runProbe(probe); });
+            }
+
+            // wait until there are no pending probes left inside the range
+            changed.wait(lock, [&] {
+                narrow();
+                bool decided = true;
+                for (auto i = round_begin; i < probes.size(); ++i) {
+                    auto &probe = probes[i];
+                    if (probe.point_ < low || probe.point_ >= high) {
+                        probe.stop_.request_stop();
+                    } else {
+                        decided = false;
+                    }
+                }
+                return decided || error;
+            });
+        }
+
+        // don't start anything else after an error, and stop what's running
+        if (error) {
+            for (auto &probe : probes) {
+                probe.stop_.request_stop();
+            }
+        }
+
+        // cancelled probes may still be running and using `pred`
+        changed.wait(lock, [&] { return running == 0; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return high;
+    }
+}
+
+class Solution {
+public:
+    template<class F>
+    static int firstBadVersion(int n, F &&isBadVersion) {
+        int low = 1;
+        int high = n;
+
+        while (low < high) {
+            int mid = (high - low) / 2 + low;
+            if (isBadVersion(mid)) {
+                // first bad version is in [low, mid]
+                high = mid;
+            } else {
+                // first bad version is in (mid, high]
+                low = mid + 1;
+            }
+        }
+
+        return high;
+    }
+};
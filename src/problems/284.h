@@ -1,5 +1,7 @@
-#include <vector>
+#pragma once
+
 #include <optional>
+#include <vector>
 
 class Iterator {
 public:
@@ -53,32 +55,3 @@ private:
 
     std::optional<int> next_;
 };
-
-#include <gtest/gtest.h>
-
-TEST(Solution, PeekingIterator) {
-    std::vector<int> one_item = {1};
-    auto item_iter = PeekingIterator(one_item);
-    EXPECT_EQ(item_iter.hasNext(), true);
-    EXPECT_EQ(item_iter.peek(), 1);
-    EXPECT_EQ(item_iter.next(), 1);
-    EXPECT_EQ(item_iter.hasNext(), false);
-
-    std::vector<int> items = {1, 2, 3, 4};
-    auto iter = PeekingIterator(items);
-
-    EXPECT_EQ(iter.peek(), 1);
-    EXPECT_EQ(iter.next(), 1);
-    EXPECT_EQ(iter.peek(), 2);
-    EXPECT_EQ(iter.next(), 2);
-    EXPECT_EQ(iter.peek(), 3);
-    EXPECT_EQ(iter.peek(), 3);
-    EXPECT_EQ(iter.next(), 3);
-    EXPECT_EQ(iter.hasNext(), true);
-    EXPECT_EQ(iter.next(), 4);
-    EXPECT_EQ(iter.hasNext(), false);
-
-    std::vector<int> no_items = {};
-    auto empty_iter = PeekingIterator(no_items);
-    EXPECT_EQ(empty_iter.hasNext(), false);
-}
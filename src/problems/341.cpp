@@ -1,107 +1,70 @@
-#include <vector>
-#include <stack>
-#include <variant>
+#include "problems/341.h"
 
-class NestedInteger {
-public:
-    NestedInteger(int value) : data_(value) {}
-    NestedInteger(std::vector<NestedInteger> list) : data_(std::move(list)) {}
+#include <stdexcept>
+#include <system_error>
 
-    // Return true if this NestedInteger holds a single integer, rather than a nested list.
-    [[nodiscard]] bool isInteger() const {
-        return std::holds_alternative<int>(data_);
-    }
-
-    // Return the single integer that this NestedInteger holds, if it holds a single integer
-    // The result is undefined if this NestedInteger holds a nested list
-    [[nodiscard]] int getInteger() const {
-        return std::get<int>(data_);
-    }
-
-    // Return the nested list that this NestedInteger holds, if it holds a nested list
-    // The result is undefined if this NestedInteger holds a single integer
-    [[nodiscard]] const std::vector<NestedInteger> &getList() const {
-        return std::get<std::vector<NestedInteger>>(data_);
-    }
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-private:
-    std::variant<int, std::vector<NestedInteger>> data_;
-};
-
-class NestedIterator {
-public:
-    explicit NestedIterator(const std::vector<NestedInteger> &nestedList) : stack_{} {
-        stack_.push(std::pair{nestedList.begin(), nestedList.end()});
-        // advance until we get to a single int
-        advance();
+FlatNestedList::FlatNestedList(const std::vector<NestedInteger> &nestedList) {
+    using item_iter = std::vector<NestedInteger>::const_iterator;
+    std::stack<std::pair<item_iter, item_iter>> stack;
+    stack.emplace(nestedList.begin(), nestedList.end());
+
+    while (!stack.empty()) {
+        auto &[current, end] = stack.top();
+        if (current == end) {
+            stack.pop();
+            // the outermost list doesn't get a header
+            if (!stack.empty()) { endList(); }
+        } else if (current->isInteger()) {
+            push((current++)->getInteger());
+        } else {
+            auto &list = (current++)->getList();
+            beginList();
+            stack.emplace(list.begin(), list.end());
+        }
     }
+}
 
-    int next() {
-        auto &[current, end] = stack_.top();
-        auto value = current->getInteger();
-        // go to next
-        ++current;
-        advance();
+void NestedTextIterator::fail(const char *what) const {
+    throw std::invalid_argument(std::string("NestedTextIterator: ") + what);
+}
 
-        return value;
+#if __has_include(<sys/mman.h>)
+MappedFile::MappedFile(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + path);
     }
 
-    [[nodiscard]] bool hasNext() const {
-        return !stack_.empty();
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat " + path);
     }
-private:
-    using item_iter = std::vector<NestedInteger>::const_iterator;
-    std::stack<std::pair<item_iter, item_iter>> stack_;
 
-    void advance() {
-        while (!stack_.empty()) {
-            auto &[current, end] = stack_.top();
-            if (current == end) {
-                // no items left on this level, go up one
-                stack_.pop();
-            } else if (!current->isInteger()) {
-                // this item isn't a single integer, add
-                // the begin/end iterators to the stack
-                // and advance `current` to indicate we're
-                // iterating over the current item
-                auto &list = current->getList();
-                ++current;
-                stack_.emplace(list.begin(), list.end());
-            } else {
-                break; // current->isInteger() == true
-            }
+    size_ = static_cast<std::size_t>(info.st_size);
+    // mmap doesn't allow zero-length mappings
+    if (size_ != 0) {
+        data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data_ == MAP_FAILED) {
+            auto error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "mmap " + path);
         }
+        // we only ever read through the file front to back
+        ::madvise(data_, size_, MADV_SEQUENTIAL);
     }
-};
-
-#include <gtest/gtest.h>
-
-TEST(Solution, FlattenNestedIterator) {
-    auto checkCase = [](const std::vector<NestedInteger>& nested,
-                        const std::vector<int>& expected) {
-
-        NestedIterator it{nested};
-        std::vector<int> actual;
-        while (it.hasNext()) {
-            actual.push_back(it.next());
-        }
-
-        EXPECT_EQ(actual, expected);
-    };
-
-    checkCase({
-                      std::vector<NestedInteger>{1, std::vector<NestedInteger>{2, 3}},
-                      4,
-                      std::vector<NestedInteger>{std::vector<NestedInteger>{}},
-                      std::vector<NestedInteger>{5, 6},
-                      7,
-                      std::vector<NestedInteger>{}
-              }, {1, 2, 3, 4, 5, 6, 7});
+    ::close(fd);
+}
 
-    checkCase({1}, {1});
-    checkCase({1, 2}, {1, 2});
-    checkCase({std::vector<NestedInteger>{}, 1}, {1});
-    checkCase({std::vector<NestedInteger>{std::vector<NestedInteger>{std::vector<NestedInteger>{1}}}}, {1});
-    checkCase({}, {});
-    checkCase({std::vector<NestedInteger>{}}, {});
+MappedFile::~MappedFile() {
+    if (size_ != 0) { ::munmap(data_, size_); }
 }
+#endif
@@ -0,0 +1,556 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <stack>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "util/work_stealing_pool.h"
+
+class NestedInteger {
+public:
+    NestedInteger(int value) : data_(value) {}
+    NestedInteger(std::vector<NestedInteger> list) : data_(std::move(list)) {}
+
+    // Return true if this NestedInteger holds a single integer, rather than a nested list.
+    [[nodiscard]] bool isInteger() const {
+        return std::holds_alternative<int>(data_);
+    }
+
+    // Return the single integer that this NestedInteger holds, if it holds a single integer
+    // The result is undefined if this NestedInteger holds a nested list
+    [[nodiscard]] int getInteger() const {
+        return std::get<int>(data_);
+    }
+
+    // Return the nested list that this NestedInteger holds, if it holds a nested list
+    // The result is undefined if this NestedInteger holds a single integer
+    [[nodiscard]] const std::vector<NestedInteger> &getList() const {
+        return std::get<std::vector<NestedInteger>>(data_);
+    }
+
+private:
+    std::variant<int, std::vector<NestedInteger>> data_;
+};
+
+class NestedIterator {
+public:
+    explicit NestedIterator(const std::vector<NestedInteger> &nestedList) : stack_{} {
+        stack_.push(std::pair{nestedList.begin(), nestedList.end()});
+        // advance until we get to a single int
+        advance();
+    }
+
+    int next() {
+        auto &[current, end] = stack_.top();
+        auto value = current->getInteger();
+        // go to next
+        ++current;
+        advance();
+
+        return value;
+    }
+
+    [[nodiscard]] bool hasNext() const {
+        return !stack_.empty();
+    }
+private:
+    using item_iter = std::vector<NestedInteger>::const_iterator;
+    std::stack<std::pair<item_iter, item_iter>> stack_;
+
+    void advance() {
+        while (!stack_.empty()) {
+            auto &[current, end] = stack_.top();
+            if (current == end) {
+                // no items left on this level, go up one
+                stack_.pop();
+            } else if (!current->isInteger()) {
+                // this item isn't a single integer, add
+                // the begin/end iterators to the stack
+                // and advance `current` to indicate we're
+                // iterating over the current item
+                auto &list = current->getList();
+                ++current;
+                stack_.emplace(list.begin(), list.end());
+            } else {
+                break; // current->isInteger() == true
+            }
+        }
+    }
+};
+
+// Flat encoding of a list of NestedIntegers, every integer and every list
+// header is stored as a single token in one contiguous array (in the same
+// order NestedIterator would visit them). List headers store the number
+// of tokens they span and whether there are any integers in them, so that
+// lists without integers (like [[], [[]]]) can be skipped in one step.
+class FlatNestedList {
+public:
+    struct Token {
+        // the integer value, or for list headers 1 if there are any
+        // integers in the list (at any depth) and 0 otherwise
+        int value_;
+        // 0 for integers, otherwise the number of tokens in the list
+        // including the header itself
+        std::uint32_t span_;
+
+        [[nodiscard]] bool isInteger() const { return span_ == 0; }
+
+        // whether this is a list header without any integers in the list
+        [[nodiscard]] bool isEmptyList() const { return !isInteger() && value_ == 0; }
+
+        // number of tokens until the next sibling
+        [[nodiscard]] std::size_t extent() const { return isInteger() ? 1 : span_; }
+    };
+
+    FlatNestedList() = default;
+
+    explicit FlatNestedList(const std::vector<NestedInteger> &nestedList);
+
+    void push(int value) {
+        tokens_.push_back(Token{value, 0});
+        num_integers_ += 1;
+    }
+
+    void beginList() {
+        open_.push_back(OpenList{tokens_.size(), num_integers_});
+        tokens_.push_back(Token{0, 1});
+    }
+
+    void endList() {
+        assert(!open_.empty());
+        auto [header, num_integers_before] = open_.back();
+        open_.pop_back();
+        tokens_[header].value_ = num_integers_ != num_integers_before ? 1 : 0;
+        tokens_[header].span_ = static_cast<std::uint32_t>(tokens_.size() - header);
+    }
+
+    void reserve(std::size_t num_tokens) { tokens_.reserve(num_tokens); }
+
+    [[nodiscard]] const std::vector<Token> &tokens() const { return tokens_; }
+
+    // @return The number of integers (not tokens) in the list.
+    [[nodiscard]] std::size_t size() const { return num_integers_; }
+
+private:
+    struct OpenList {
+        std::size_t header_;
+        // num_integers_ when the list was started
+        std::size_t num_integers_before_;
+    };
+
+    std::vector<Token> tokens_;
+    // lists that have been started but not ended yet
+    std::vector<OpenList> open_;
+    std::size_t num_integers_ = 0;
+};
+
+// Same interface as NestedIterator, but since the tokens are already in
+// order this is just a linear scan that steps into list headers, or over
+// the whole list if there are no integers in it.
+class FlatNestedIterator {
+public:
+    explicit FlatNestedIterator(const FlatNestedList &list) :
+            current_(list.tokens().data()),
+            end_(list.tokens().data() + list.tokens().size())
+    {
+        advance();
+    }
+
+    int next() {
+        auto value = current_->value_;
+        ++current_;
+        advance();
+
+        return value;
+    }
+
+    [[nodiscard]] bool hasNext() const {
+        return current_ != end_;
+    }
+
+private:
+    void advance() {
+        while (current_ != end_ && !current_->isInteger()) {
+            current_ += current_->isEmptyList() ? current_->extent() : 1;
+        }
+    }
+
+    const FlatNestedList::Token *current_;
+    const FlatNestedList::Token *end_;
+};
+
+// Streaming version of NestedIterator that flattens bracketed text like
+// "[1,[2,3],4]" directly, without building any NestedIntegers. The only
+// state kept is the current position, nesting depth and which token may
+// come next, so memory use is constant regardless of the size of the
+// input. Malformed input throws std::invalid_argument. Multiple top-level lists
+// may follow each other, e.g. "[1,2] [3]".
+class NestedTextIterator {
+public:
+    explicit NestedTextIterator(std::string_view text) :
+            current_(text.data()),
+            end_(text.data() + text.size())
+    {
+        advance();
+    }
+
+    int next() {
+        auto value = next_;
+        advance();
+        return value;
+    }
+
+    [[nodiscard]] bool hasNext() const {
+        return has_next_;
+    }
+
+    // @return The current nesting depth, 0 once the input is exhausted.
+    [[nodiscard]] std::size_t depth() const {
+        return depth_;
+    }
+
+private:
+    void advance() {
+        while (current_ != end_) {
+            char c = *current_;
+            if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+                ++current_;
+            } else if (c == '[') {
+                if (expect_ == Expect::separator) { fail("expected ',' or ']'"); }
+                depth_ += 1;
+                expect_ = Expect::value_or_end;
+                ++current_;
+            } else if (c == ']') {
+                if (depth_ == 0) { fail("unmatched ']'"); }
+                if (expect_ == Expect::value) { fail("expected a value after ','"); }
+                depth_ -= 1;
+                expect_ = depth_ == 0 ? Expect::list : Expect::separator;
+                ++current_;
+            } else if (c == ',') {
+                if (expect_ != Expect::separator) { fail("unexpected ','"); }
+                expect_ = Expect::value;
+                ++current_;
+            } else if (c == '-' || isDigit(c)) {
+                if (depth_ == 0) { fail("integer outside of a list"); }
+                if (expect_ == Expect::separator) { fail("expected ',' or ']'"); }
+                next_ = parseInteger();
+                expect_ = Expect::separator;
+                has_next_ = true;
+                return;
+            } else {
+                fail("unexpected character");
+            }
+        }
+
+        if (depth_ != 0) { fail("unterminated list"); }
+        has_next_ = false;
+    }
+
+    int parseInteger() {
+        bool negative = *current_ == '-';
+        if (negative) { ++current_; }
+
+        std::size_t num_digits = countDigits();
+        // 10 digits is enough for any int, leading zeros aside
+        if (num_digits == 0 || num_digits > 10) { fail("invalid integer"); }
+
+        std::int64_t value = 0;
+        for (std::size_t i = 0; i < num_digits; ++i) {
+            value = value * 10 + (current_[i] - '0');
+        }
+        current_ += num_digits;
+
+        if (negative) { value = -value; }
+        if (value < INT32_MIN || value > INT32_MAX) { fail("integer out of range"); }
+        return static_cast<int>(value);
+    }
+
+    // @return The number of consecutive digits starting at current_.
+    [[nodiscard]] std::size_t countDigits() const {
+#if defined(__SSE2__)
+        // note that we can't read past end_, since the input might be a
+        // memory mapped file ending right at a page boundary
+        if (end_ - current_ >= 16) {
+            auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current_));
+            // SSE2 only has signed comparisons, so shift '0'..'9' down to -128..-119
+            // and check for anything less than -118
+            auto shifted = _mm_add_epi8(chunk, _mm_set1_epi8(static_cast<char>(128 - '0')));
+            auto is_digit = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-118));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(is_digit));
+            // the extra bit takes care of the case where all 16 bytes are digits
+            return static_cast<std::size_t>(__builtin_ctz(~mask | 0x10000u));
+        }
+#endif
+        std::size_t num_digits = 0;
+        while (current_ + num_digits != end_ && isDigit(current_[num_digits])) {
+            num_digits += 1;
+        }
+        return num_digits;
+    }
+
+    static bool isDigit(char c) {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    [[noreturn]] void fail(const char *what) const;
+
+    // what may come next, apart from whitespace
+    enum class Expect {
+        // '[' starting a top-level list
+        list,
+        // a value or ']', right after '['
+        value_or_end,
+        // a value, after ','
+        value,
+        // ',' or ']', after a value
+        separator
+    };
+
+    const char *current_;
+    const char *end_;
+    std::size_t depth_ = 0;
+    Expect expect_ = Expect::list;
+    int next_ = 0;
+    bool has_next_ = false;
+};
+
+#if __has_include(<sys/mman.h>)
+// Read-only memory mapping of a whole file, e.g. for use with NestedTextIterator.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path);
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    [[nodiscard]] std::string_view view() const {
+        return {static_cast<const char *>(data_), size_};
+    }
+
+private:
+    void *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+#endif
+
+// Parallel algorithms over the integers in a list of NestedIntegers. Work is
+// split at list boundaries: lists are cut into chunks of `grain_size` items,
+// and any sub-list with at least `grain_size` items found while walking a
+// chunk is handed off to its own task instead of being walked in place.
+namespace parallel_nested {
+    constexpr std::size_t grain_size = 1024;
+
+    struct ChunkCounts;
+
+    // number of selected integers in a list, per chunk
+    struct ListCounts {
+        std::size_t count_ = 0;
+        std::vector<ChunkCounts> chunks_;
+    };
+
+    struct ChunkCounts {
+        std::size_t count_ = 0;
+        // counts for the sub-lists that were split off while walking the chunk,
+        // in the order they were found (deque so that references stay valid
+        // while other tasks are filling them in)
+        std::deque<ListCounts> split_;
+    };
+
+    using item_iter = std::vector<NestedInteger>::const_iterator;
+
+    inline std::size_t numChunks(const std::vector<NestedInteger> &list) {
+        return (list.size() + grain_size - 1) / grain_size;
+    }
+
+    inline std::pair<item_iter, item_iter> chunkRange(const std::vector<NestedInteger> &list, std::size_t chunk) {
+        auto begin = list.begin() + static_cast<std::ptrdiff_t>(chunk * grain_size);
+        auto end = list.begin() + static_cast<std::ptrdiff_t>(std::min(list.size(), (chunk + 1) * grain_size));
+        return {begin, end};
+    }
+
+    // Calls `leaf(int)` for every integer in [begin, end) in order and `split(list)`
+    // for every large sub-list instead of descending into it.
+    template<class Leaf, class Split>
+    void walk(item_iter begin, item_iter end, Leaf &leaf, Split &split) {
+        for (auto it = begin; it != end; ++it) {
+            if (it->isInteger()) {
+                leaf(it->getInteger());
+            } else if (it->getList().size() >= grain_size) {
+                split(it->getList());
+            } else {
+                walk(it->getList().begin(), it->getList().end(), leaf, split);
+            }
+        }
+    }
+
+    // First pass of copyIf(), count the integers matching `pred` in every chunk.
+    template<class Pred>
+    void countList(const std::vector<NestedInteger> &list, ListCounts &counts,
+                   const Pred &pred, WorkStealingPool &pool) {
+        counts.chunks_.resize(numChunks(list));
+
+        TaskGroup group(pool);
+        for (std::size_t c = 0; c < counts.chunks_.size(); ++c) {
+            group.spawn([&, c] {
+                auto &chunk = counts.chunks_[c];
+                TaskGroup split_group(pool);
+
+                std::size_t count = 0;
+                auto leaf = [&](int value) { count += pred(value) ? 1 : 0; };
+                auto split = [&](const std::vector<NestedInteger> &sub_list) {
+                    auto &sub_counts = chunk.split_.emplace_back();
+                    split_group.spawn([&] { countList(sub_list, sub_counts, pred, pool); });
+                };
+
+                auto [begin, end] = chunkRange(list, c);
+                walk(begin, end, leaf, split);
+                split_group.wait();
+
+                for (auto &sub_counts : chunk.split_) {
+                    count += sub_counts.count_;
+                }
+                chunk.count_ = count;
+            });
+        }
+        group.wait();
+
+        for (auto &chunk : counts.chunks_) {
+            counts.count_ += chunk.count_;
+        }
+    }
+
+    // Second pass of copyIf(), every chunk knows exactly where its output starts.
+    template<class Pred>
+    void writeList(const std::vector<NestedInteger> &list, const ListCounts &counts,
+                   int *out, const Pred &pred, WorkStealingPool &pool) {
+        TaskGroup group(pool);
+        for (std::size_t c = 0; c < counts.chunks_.size(); ++c) {
+            group.spawn([&, c, out] () mutable {
+                auto &chunk = counts.chunks_[c];
+                TaskGroup split_group(pool);
+
+                auto next_split = chunk.split_.begin();
+                auto leaf = [&](int value) {
+                    if (pred(value)) { *out++ = value; }
+                };
+                auto split = [&](const std::vector<NestedInteger> &sub_list) {
+                    auto &sub_counts = *next_split++;
+                    split_group.spawn([&, out] { writeList(sub_list, sub_counts, out, pred, pool); });
+                    out += sub_counts.count_;
+                };
+
+                auto [begin, end] = chunkRange(list, c);
+                walk(begin, end, leaf, split);
+                split_group.wait();
+            });
+            out += counts.chunks_[c].count_;
+        }
+        group.wait();
+    }
+
+    // @return Everything in `list` reduced, or nothing if it has no integers
+    //         (init is left to the caller so that it's only added once).
+    template<class T, class Reduce, class Transform>
+    std::optional<T> transformReduceList(const std::vector<NestedInteger> &list, const Reduce &reduce,
+                                         const Transform &transform, WorkStealingPool &pool) {
+        std::vector<std::optional<T>> results(numChunks(list));
+
+        TaskGroup group(pool);
+        for (std::size_t c = 0; c < results.size(); ++c) {
+            group.spawn([&, c] {
+                TaskGroup split_group(pool);
+                std::deque<std::optional<T>> split_results;
+
+                std::optional<T> result;
+                auto leaf = [&](int value) {
+                    result = result ? reduce(std::move(*result), transform(value)) : transform(value);
+                };
+                auto split = [&](const std::vector<NestedInteger> &sub_list) {
+                    auto &sub_result = split_results.emplace_back();
+                    split_group.spawn([&] {
+                        sub_result = transformReduceList<T>(sub_list, reduce, transform, pool);
+                    });
+                };
+
+                auto [begin, end] = chunkRange(list, c);
+                walk(begin, end, leaf, split);
+                split_group.wait();
+
+                for (auto &sub_result : split_results) {
+                    if (!sub_result) { continue; }
+                    result = result ? reduce(std::move(*result), std::move(*sub_result)) : std::move(sub_result);
+                }
+                results[c] = std::move(result);
+            });
+        }
+        group.wait();
+
+        std::optional<T> total;
+        for (auto &result : results) {
+            if (!result) { continue; }
+            total = total ? reduce(std::move(*total), std::move(*result)) : std::move(result);
+        }
+        return total;
+    }
+}
+
+// @return All integers in `nestedList` matching `pred`, in the same order as NestedIterator.
+template<class Pred>
+std::vector<int> parallelCopyIf(const std::vector<NestedInteger> &nestedList, const Pred &pred,
+                                WorkStealingPool &pool = WorkStealingPool::global()) {
+    // two passes, one to find out where each chunk's output goes, and
+    // another to actually write it
+    parallel_nested::ListCounts counts;
+    parallel_nested::countList(nestedList, counts, pred, pool);
+
+    std::vector<int> flat(counts.count_);
+    parallel_nested::writeList(nestedList, counts, flat.data(), pred, pool);
+    return flat;
+}
+
+// @return All integers in `nestedList`, in the same order as NestedIterator.
+inline std::vector<int> parallelFlatten(const std::vector<NestedInteger> &nestedList,
+                                        WorkStealingPool &pool = WorkStealingPool::global()) {
+    return parallelCopyIf(nestedList, [](int) { return true; }, pool);
+}
+
+// Like std::transform_reduce, `reduce` must be associative and commutative
+// since the order integers are combined in is unspecified.
+template<class T, class Reduce, class Transform>
+T parallelTransformReduce(const std::vector<NestedInteger> &nestedList, T init,
+                          const Reduce &reduce, const Transform &transform,
+                          WorkStealingPool &pool = WorkStealingPool::global()) {
+    auto result = parallel_nested::transformReduceList<T>(nestedList, reduce, transform, pool);
+    return result ? reduce(std::move(init), std::move(*result)) : init;
+}
+
+template<class T, class Reduce>
+T parallelReduce(const std::vector<NestedInteger> &nestedList, T init, const Reduce &reduce,
+                 WorkStealingPool &pool = WorkStealingPool::global()) {
+    return parallelTransformReduce(nestedList, std::move(init), reduce,
+                                   [](int value) { return T(value); }, pool);
+}
+
+// Calls `f` for every integer in `nestedList`, possibly concurrently and in no particular order.
+template<class F>
+void parallelForEach(const std::vector<NestedInteger> &nestedList, const F &f,
+                     WorkStealingPool &pool = WorkStealingPool::global()) {
+    struct Unit {};
+    parallelTransformReduce(nestedList, Unit{},
+                            [](Unit, Unit) { return Unit{}; },
+                            [&f](int value) { f(value); return Unit{}; }, pool);
+}
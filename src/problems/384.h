@@ -0,0 +1,22 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+class Solution {
+public:
+    explicit Solution(std::vector<int> nums,
+                      std::mt19937::result_type seed = std::mt19937::default_seed) :
+        nums_(std::move(nums)),
+        rng_(seed) {}
+
+    [[nodiscard]] const std::vector<int> &reset() const {
+        return nums_;
+    }
+
+    [[nodiscard]] std::vector<int> shuffle();
+
+private:
+    std::vector<int> nums_;
+    std::mt19937 rng_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+
+#include <boost/container_hash/hash.hpp>
+
+/// Reference implementation used to check isMatch.
+std::regex patternToRegex(const std::string &pattern);
+
+bool isMatchRegex(const std::string &input, const std::string &pattern);
+
+struct TupleHash {
+    template<class ...Args>
+    std::size_t operator()(const std::tuple<Args...> &value) const {
+        return hash_impl(value, std::index_sequence_for<Args...>{});
+    }
+
+private:
+    template<class ...Args, std::size_t ...Is>
+    std::size_t hash_impl(const std::tuple<Args...> &value,
+                          std::index_sequence<Is...>) const {
+        std::size_t seed = 0;
+        // adapted from boost::hash_combine
+        auto hash_combine = [&seed](auto &x) {
+            using T = std::remove_const_t<std::remove_reference_t<decltype(x)>>;
+            auto hash = std::hash<T>()(x);
+            seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        };
+        // hash all tuple values & combine
+        (hash_combine(std::get<Is>(value)) , ...);
+        return seed;
+    }
+};
+
+template<class, class...>
+class Memoizer;
+
+template<class R, class ...Args>
+class Memoizer<R(Args...)> {
+public:
+    std::optional<R> & get(Args ...args) {
+        return cache_[std::tuple{args...}];
+    }
+
+    void reserve(std::size_t n) { cache_.reserve(n); }
+    void clear() { cache_.clear(); }
+private:
+    std::unordered_map<std::tuple<Args...>, std::optional<R>, TupleHash> cache_;
+};
+
+class Solution {
+public:
+    static bool isMatch(const std::string &input, std::string pattern);
+
+private:
+    static std::string coalescePatternWildcards(std::string pattern);
+
+    static bool isMatchRecursive(std::string_view input,
+                                 std::string_view pattern,
+                                 std::size_t needed_input_chars,
+                                 Memoizer<bool(std::size_t, std::size_t)> &memoizer);
+};
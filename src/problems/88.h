@@ -0,0 +1,10 @@
+#pragma once
+
+#include <vector>
+
+// https://leetcode.com/explore/interview/card/top-interview-questions-easy/96/sorting-and-searching/587/
+class Solution {
+public:
+    static void merge(std::vector<int>& nums1, int m,
+                      std::vector<int>& nums2, int n);
+};
@@ -0,0 +1,88 @@
+// Replacements for the global operator new/delete that count allocations per
+// thread, only built into the executables with -DLEETCODE_INSTRUMENT=ON.
+#include "util/instrument.h"
+
+#include <cstdlib>
+#include <new>
+
+// trivially constructible, so accessing it can't allocate
+static thread_local instrument::AllocationStats allocation_stats;
+
+namespace instrument {
+    bool allocationsTracked() {
+        return true;
+    }
+
+    AllocationStats allocationStats() {
+        return allocation_stats;
+    }
+}
+
+static void *allocate(std::size_t size, std::size_t alignment) {
+    allocation_stats.allocations_ += 1;
+    allocation_stats.bytes_ += size;
+
+    // new(0) still has to return a unique pointer
+    if (size == 0) { size = 1; }
+    while (true) {
+        void *ptr;
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ptr = std::malloc(size);
+        } else {
+            // aligned_alloc wants the size to be a multiple of the alignment
+            ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+        if (ptr) { return ptr; }
+
+        auto handler = std::get_new_handler();
+        if (!handler) { throw std::bad_alloc(); }
+        handler();
+    }
+}
+
+static void *allocateNoThrow(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return allocate(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+static void deallocate(void *ptr) noexcept {
+    if (!ptr) { return; }
+    allocation_stats.deallocations_ += 1;
+    std::free(ptr);
+}
+
+constexpr std::size_t default_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+void *operator new(std::size_t size) { return allocate(size, default_alignment); }
+void *operator new[](std::size_t size) { return allocate(size, default_alignment); }
+void *operator new(std::size_t size, std::align_val_t align) { return allocate(size, static_cast<std::size_t>(align)); }
+void *operator new[](std::size_t size, std::align_val_t align) { return allocate(size, static_cast<std::size_t>(align)); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return allocateNoThrow(size, default_alignment);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return allocateNoThrow(size, default_alignment);
+}
+void *operator new(std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept {
+    return allocateNoThrow(size, static_cast<std::size_t>(align));
+}
+void *operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept {
+    return allocateNoThrow(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(ptr); }
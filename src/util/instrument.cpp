@@ -0,0 +1,126 @@
+#include "util/instrument.h"
+
+#include <cerrno>
+
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define LEETCODE_HAVE_PERF_EVENT 1
+#endif
+
+namespace instrument {
+#ifndef LEETCODE_INSTRUMENT
+    // the real ones are next to the operator new/delete replacements
+    bool allocationsTracked() {
+        return false;
+    }
+
+    AllocationStats allocationStats() {
+        return {};
+    }
+#endif
+
+    const char *eventName(Event event) {
+        switch (event) {
+            case Event::cycles: return "cycles";
+            case Event::instructions: return "instructions";
+            case Event::l1d_misses: return "L1d_misses";
+            case Event::llc_misses: return "LLC_misses";
+            case Event::branch_misses: return "branch_misses";
+        }
+        return "unknown";
+    }
+
+#ifdef LEETCODE_HAVE_PERF_EVENT
+    static int openEvent(Event event) {
+        constexpr auto cache_read_miss = [](std::uint64_t cache) {
+            return cache
+                   | (static_cast<std::uint64_t>(PERF_COUNT_HW_CACHE_OP_READ) << 8)
+                   | (static_cast<std::uint64_t>(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+        };
+
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        switch (event) {
+            case Event::cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case Event::instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case Event::l1d_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache_read_miss(PERF_COUNT_HW_CACHE_L1D);
+                break;
+            case Event::llc_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache_read_miss(PERF_COUNT_HW_CACHE_LL);
+                break;
+            case Event::branch_misses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+        }
+        // user space only, which is also all that perf_event_paranoid = 2
+        // (the usual default) allows
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+#endif
+
+    PerfCounters::PerfCounters() {
+        fds_.fill(-1);
+#ifdef LEETCODE_HAVE_PERF_EVENT
+        for (std::size_t i = 0; i < num_events; ++i) {
+            fds_[i] = openEvent(static_cast<Event>(i));
+            if (fds_[i] < 0 && error_ == 0) { error_ = errno; }
+        }
+#else
+        error_ = ENOSYS;
+#endif
+    }
+
+    PerfCounters::~PerfCounters() {
+#ifdef LEETCODE_HAVE_PERF_EVENT
+        for (int fd : fds_) {
+            if (fd >= 0) { ::close(fd); }
+        }
+#endif
+    }
+
+    bool PerfCounters::anyAvailable() const {
+        for (int fd : fds_) {
+            if (fd >= 0) { return true; }
+        }
+        return false;
+    }
+
+    std::optional<std::uint64_t> PerfCounters::read(Event event) const {
+#ifdef LEETCODE_HAVE_PERF_EVENT
+        int fd = fds_[static_cast<std::size_t>(event)];
+        if (fd < 0) { return std::nullopt; }
+
+        struct {
+            std::uint64_t value_;
+            std::uint64_t time_enabled_;
+            std::uint64_t time_running_;
+        } sample{};
+        if (::read(fd, &sample, sizeof(sample)) != sizeof(sample) || sample.time_running_ == 0) {
+            return std::nullopt;
+        }
+
+        if (sample.time_running_ == sample.time_enabled_) { return sample.value_; }
+        auto scale = static_cast<double>(sample.time_enabled_) / static_cast<double>(sample.time_running_);
+        return static_cast<std::uint64_t>(static_cast<double>(sample.value_) * scale);
+#else
+        static_cast<void>(event);
+        return std::nullopt;
+#endif
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// Opt-in instrumentation for tests and benchmarks. Allocation counts come
+// from replacing the global operator new/delete (src/util/alloc_hooks.cpp,
+// only linked in with -DLEETCODE_INSTRUMENT=ON), and hardware counters
+// from perf_event_open on Linux.
+namespace instrument {
+    struct AllocationStats {
+        std::uint64_t allocations_ = 0;
+        std::uint64_t deallocations_ = 0;
+        // total requested by all allocations, nothing is subtracted on free
+        std::uint64_t bytes_ = 0;
+    };
+
+    // @return Whether operator new/delete are hooked, allocationStats()
+    //         is always zero otherwise.
+    bool allocationsTracked();
+
+    // @return The allocations made by the calling thread so far.
+    AllocationStats allocationStats();
+
+    enum class Event {
+        cycles,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        branch_misses
+    };
+
+    constexpr std::size_t num_events = 5;
+
+    const char *eventName(Event event);
+
+    // Hardware counters for the calling thread (user space only) that start
+    // counting on construction. Events that can't be opened, because the
+    // CPU or VM doesn't have them or perf_event_paranoid doesn't allow it,
+    // are just unavailable instead of being an error.
+    class PerfCounters {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        [[nodiscard]] bool available(Event event) const {
+            return fds_[static_cast<std::size_t>(event)] >= 0;
+        }
+
+        [[nodiscard]] bool anyAvailable() const;
+
+        // @return The count since construction, scaled up if the kernel had
+        //         to multiplex the counter, or nothing if unavailable.
+        [[nodiscard]] std::optional<std::uint64_t> read(Event event) const;
+
+        // @return The errno of the first event that failed to open, 0 if none did.
+        [[nodiscard]] int error() const {
+            return error_;
+        }
+
+    private:
+        std::array<int, num_events> fds_;
+        int error_ = 0;
+    };
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixed-size thread pool where every worker has its own task queue. Workers
+// take tasks from the back of their own queue (most recently spawned first,
+// which keeps fork-join recursion cache-friendly) and, when that runs dry,
+// steal from the front of the other workers' queues.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(std::size_t num_threads = defaultThreads()) :
+            queues_(),
+            workers_()
+    {
+        num_threads = std::max<std::size_t>(num_threads, 1);
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    // Finishes all queued tasks before joining the workers.
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    static WorkStealingPool &global() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return workers_.size();
+    }
+
+    void submit(std::function<void()> task) {
+        // tasks spawned by one of our own workers stay local to that worker
+        auto index = current_pool_ == this
+                ? current_worker_
+                : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            auto &queue = *queues_[index];
+            std::lock_guard lock(queue.mutex_);
+            queue.tasks_.push_back(std::move(task));
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+
+        // lock so that a worker can't miss the update between checking
+        // `queued_` and going to sleep
+        { std::lock_guard lock(sleep_mutex_); }
+        wake_.notify_one();
+    }
+
+    // Runs a single queued task on the calling thread, used to help out
+    // while waiting on other tasks instead of blocking a worker.
+    // @return Whether a task was run.
+    bool tryRunOne() {
+        auto start = current_pool_ == this ? current_worker_ : 0;
+        std::function<void()> task;
+        if (tryPop(start, task)) {
+            task();
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex_;
+        std::deque<std::function<void()>> tasks_;
+    };
+
+    static std::size_t defaultThreads() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // try the queue at `start` first (LIFO), and then steal from the rest (FIFO)
+    bool tryPop(std::size_t start, std::function<void()> &task) {
+        if (queued_.load(std::memory_order_acquire) == 0) { return false; }
+
+        {
+            auto &own = *queues_[start];
+            std::lock_guard lock(own.mutex_);
+            if (!own.tasks_.empty()) {
+                task = std::move(own.tasks_.back());
+                own.tasks_.pop_back();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            auto &victim = *queues_[(start + i) % queues_.size()];
+            std::lock_guard lock(victim.mutex_);
+            if (!victim.tasks_.empty()) {
+                task = std::move(victim.tasks_.front());
+                victim.tasks_.pop_front();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(std::size_t index) {
+        current_pool_ = this;
+        current_worker_ = index;
+
+        std::function<void()> task;
+        while (true) {
+            if (tryPop(index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock lock(sleep_mutex_);
+            wake_.wait(lock, [this] {
+                return stopping_ || queued_.load(std::memory_order_acquire) != 0;
+            });
+            if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<std::size_t> queued_ = 0;
+    std::atomic<std::size_t> next_queue_ = 0;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+
+    static inline thread_local WorkStealingPool *current_pool_ = nullptr;
+    static inline thread_local std::size_t current_worker_ = 0;
+};
+
+// Fork-join scope on top of WorkStealingPool. Waiting runs queued tasks on
+// the calling thread, so groups can be nested inside tasks without
+// deadlocking the pool, and once there's nothing left to run it sleeps
+// until one of the group's tasks finishes.
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool &pool = WorkStealingPool::global()) :
+            pool_(pool) {}
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    ~TaskGroup() {
+        // can't throw from here, wait() should have been called if the
+        // caller cares about errors
+        help();
+    }
+
+    template<class F>
+    void spawn(F &&f) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.submit([this, f = std::forward<F>(f)]() mutable {
+            try {
+                f();
+            } catch (...) {
+                std::lock_guard lock(error_mutex_);
+                if (!error_) { error_ = std::current_exception(); }
+            }
+            // the group may be destroyed as soon as both counts are zero,
+            // so nothing may touch `this` after the second decrement
+            completing_.fetch_add(1, std::memory_order_relaxed);
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pending_.notify_all();
+            }
+            completing_.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    // Waits for all spawned tasks, rethrowing the first exception any of them threw.
+    void wait() {
+        help();
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+private:
+    // failed attempts at finding a task to run before going to sleep
+    static constexpr std::size_t max_idle_spins = 64;
+
+    void help() {
+        std::size_t idle_spins = 0;
+        while (true) {
+            auto pending = pending_.load(std::memory_order_acquire);
+            if (pending == 0) { break; }
+
+            if (pool_.tryRunOne()) {
+                idle_spins = 0;
+            } else if (++idle_spins < max_idle_spins) {
+                std::this_thread::yield();
+            } else {
+                // the remaining tasks are running elsewhere
+                pending_.wait(pending, std::memory_order_acquire);
+            }
+        }
+
+        // the last task may still be in notify_all()
+        while (completing_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    WorkStealingPool &pool_;
+    std::atomic<std::size_t> pending_ = 0;
+    // tasks between finishing and being done with `this`
+    std::atomic<std::size_t> completing_ = 0;
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
@@ -0,0 +1,239 @@
+#include "problems/146.h"
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <ostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "differential.h"
+
+TEST(Solution, LRUCache) {
+    // capacity = 4
+    {
+        LRUCache cache(4);
+        cache.put(1, 1);
+        cache.put(2, 2);
+        cache.put(3, 3);
+        cache.put(4, 4);
+
+        EXPECT_EQ(cache.get(2), 2);
+        EXPECT_EQ(cache.get(3), 3);
+        cache.put(5, 5);
+        EXPECT_EQ(cache.get(1), -1);
+        cache.put(6, 6);
+        EXPECT_EQ(cache.get(4), -1);
+        EXPECT_EQ(cache.get(2), 2);
+        cache.put(7, 7);
+        EXPECT_EQ(cache.get(3), -1);
+        cache.put(7, 7);
+        cache.put(7, 5);
+        EXPECT_EQ(cache.get(7), 5);
+        cache.put(7, 7);
+        EXPECT_EQ(cache.get(7), 7);
+        EXPECT_EQ(cache.get(6), 6);
+        EXPECT_EQ(cache.get(5), 5);
+        EXPECT_EQ(cache.get(2), 2);
+    }
+
+    // capacity = 2
+    {
+        LRUCache cache(2);
+        cache.put(1, 1);
+        cache.put(2, 2);
+        EXPECT_EQ(cache.get(1), 1);
+        cache.put(3, 3);
+        EXPECT_EQ(cache.get(2), -1);
+        cache.put(4, 4);
+        EXPECT_EQ(cache.get(1), -1);
+        EXPECT_EQ(cache.get(3), 3);
+        EXPECT_EQ(cache.get(4), 4);
+        // repeat oldest & newest
+        EXPECT_EQ(cache.get(3), 3);
+        EXPECT_EQ(cache.get(3), 3);
+        cache.put(4, 44);
+        cache.put(2, 22);
+        EXPECT_EQ(cache.get(3), -1);
+        EXPECT_EQ(cache.get(4), 44);
+    }
+    // capacity = 1
+    {
+        LRUCache cache(1);
+        cache.put(2, 1);
+        EXPECT_EQ(cache.get(2), 1);
+        cache.put(3, 2);
+        EXPECT_EQ(cache.get(2), -1);
+        EXPECT_EQ(cache.get(3), 2);
+    }
+    // capacity = 1
+    {
+        LRUCache cache(1);
+        EXPECT_EQ(cache.get(1), -1);
+        cache.put(1, 1); // cache is {1=1}
+        EXPECT_EQ(cache.get(1), 1);
+        cache.put(2, 2); // cache is {2=2}
+        EXPECT_EQ(cache.get(1), -1);
+        EXPECT_EQ(cache.get(2), 2);
+        cache.put(2, 3); // cache is {2=3}
+        EXPECT_EQ(cache.get(2), 3);
+    }
+    // capacity = 0
+    {
+        LRUCache cache(0);
+        EXPECT_EQ(cache.get(1), -1);
+        cache.put(1, 1);
+        EXPECT_EQ(cache.get(1), -1);
+    }
+}
+
+// Reference LRU cache, most recently used first.
+class NaiveLRUCache {
+public:
+    explicit NaiveLRUCache(std::size_t capacity) : capacity_(capacity) {}
+
+    int get(int key) {
+        auto it = find(key);
+        if (it == entries_.end()) { return -1; }
+        entries_.splice(entries_.begin(), entries_, it);
+        return it->second;
+    }
+
+    void put(int key, int value) {
+        if (auto it = find(key); it != entries_.end()) {
+            entries_.erase(it);
+        }
+        entries_.emplace_front(key, value);
+        if (entries_.size() > capacity_) { entries_.pop_back(); }
+    }
+
+private:
+    std::list<std::pair<int, int>>::iterator find(int key) {
+        return std::find_if(entries_.begin(), entries_.end(),
+                            [key](auto &entry) { return entry.first == key; });
+    }
+
+    std::size_t capacity_;
+    std::list<std::pair<int, int>> entries_;
+};
+
+struct CacheOp {
+    bool put_;
+    int key_;
+    int value_;
+};
+
+struct CacheOps {
+    std::size_t capacity_;
+    std::vector<CacheOp> ops_;
+};
+
+static std::ostream &operator<<(std::ostream &out, const CacheOp &op) {
+    if (op.put_) { return out << "put(" << op.key_ << ", " << op.value_ << ")"; }
+    return out << "get(" << op.key_ << ")";
+}
+
+static std::ostream &operator<<(std::ostream &out, const CacheOps &input) {
+    out << "capacity " << input.capacity_ << ":";
+    for (auto &op : input.ops_) { out << " " << op; }
+    return out;
+}
+
+static CacheOps generateCacheOps(std::mt19937_64 &rng) {
+    std::uniform_int_distribution<std::size_t> capacity_dist(0, 6);
+    std::uniform_int_distribution<std::size_t> size_dist(0, 64);
+    // few enough keys that there are plenty of hits and evictions
+    std::uniform_int_distribution<int> key_dist(0, 9);
+    std::uniform_int_distribution<int> value_dist(0, 99);
+    std::bernoulli_distribution put_dist(0.5);
+
+    CacheOps input{capacity_dist(rng), std::vector<CacheOp>(size_dist(rng))};
+    for (auto &op : input.ops_) { op = CacheOp{put_dist(rng), key_dist(rng), value_dist(rng)}; }
+    return input;
+}
+
+static std::vector<CacheOps> shrinkCacheOps(const CacheOps &input) {
+    std::vector<CacheOps> candidates;
+    if (input.capacity_ > 0) {
+        candidates.push_back(CacheOps{input.capacity_ - 1, input.ops_});
+    }
+    auto simplify = [](const CacheOp &op) {
+        std::vector<CacheOp> simpler;
+        for (int key : differential::shrinkInt(op.key_)) { simpler.push_back(CacheOp{op.put_, key, op.value_}); }
+        for (int value : differential::shrinkInt(op.value_)) { simpler.push_back(CacheOp{op.put_, op.key_, value}); }
+        return simpler;
+    };
+    for (auto &ops : differential::shrinkSequence(input.ops_, simplify)) {
+        candidates.push_back(CacheOps{input.capacity_, ops});
+    }
+    return candidates;
+}
+
+template<class Cache>
+static bool matchesNaiveLRUCache(const CacheOps &input) {
+    Cache cache(input.capacity_);
+    NaiveLRUCache reference(input.capacity_);
+    for (auto &op : input.ops_) {
+        if (op.put_) {
+            cache.put(op.key_, op.value_);
+            reference.put(op.key_, op.value_);
+        } else if (cache.get(op.key_) != reference.get(op.key_)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(Differential, LRUCache) {
+    differential::check(generateCacheOps, shrinkCacheOps, matchesNaiveLRUCache<LRUCache>);
+}
+
+// with a single thread no reads are dropped, so it's exactly LRU
+TEST(Differential, ConcurrentLRUCache) {
+    differential::check(generateCacheOps, shrinkCacheOps, matchesNaiveLRUCache<ConcurrentLRUCache>);
+}
+
+TEST(Solution, ConcurrentLRUCache) {
+    constexpr std::size_t capacity = 64;
+    constexpr int num_keys = 256;
+    constexpr int num_readers = 4;
+    ConcurrentLRUCache cache(capacity);
+
+    // values encode their key, so readers can check they never see a
+    // value paired with the wrong key
+    std::atomic<bool> done = false;
+    std::atomic<std::size_t> mismatches = 0;
+    std::vector<std::thread> readers;
+    for (int t = 0; t < num_readers; ++t) {
+        readers.emplace_back([&, t] {
+            int key = t;
+            while (!done.load(std::memory_order_relaxed)) {
+                key = (key * 31 + 7) % num_keys;
+                auto value = cache.get(key);
+                if (value != -1 && value / 1000 != key) { mismatches += 1; }
+            }
+        });
+    }
+
+    // enough puts to evict and rebuild the table many times over
+    for (int i = 0; i < 200'000; ++i) {
+        auto key = (i * 17) % num_keys;
+        cache.put(key, key * 1000 + i % 1000);
+    }
+    done = true;
+    for (auto &reader : readers) { reader.join(); }
+    EXPECT_EQ(mismatches, 0);
+
+    // `capacity` fresh keys push out all of the old ones
+    for (int key = num_keys; key < num_keys + static_cast<int>(capacity); ++key) {
+        cache.put(key, key);
+    }
+    for (int key = 0; key < num_keys; ++key) {
+        EXPECT_EQ(cache.get(key), -1);
+    }
+    for (int key = num_keys; key < num_keys + static_cast<int>(capacity); ++key) {
+        EXPECT_EQ(cache.get(key), key);
+    }
+}
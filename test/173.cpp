@@ -0,0 +1,222 @@
+#include "problems/173.h"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include <random>
+#include <gtest/gtest.h>
+
+#include "differential.h"
+
+TEST(Solution, BSTIterator) {
+    using TN = TreeNode;
+    auto check = [](TreeNode node, int num_expected) {
+        std::vector<int> expected(num_expected);
+        std::iota(expected.begin(), expected.end(), 1);
+
+        auto drain = [num_expected](auto &iter) {
+            std::vector<int> actual;
+            for (int i = 1; i <= num_expected; ++i) {
+                if (iter.hasNext()) {
+                    actual.push_back(iter.next());
+                }
+            }
+            EXPECT_FALSE(iter.hasNext());
+            return actual;
+        };
+
+        auto iter = BSTIterator(&node);
+        EXPECT_EQ(drain(iter), expected);
+
+        {
+            auto morris = MorrisBSTIterator(&node);
+            EXPECT_EQ(drain(morris), expected);
+        }
+        {
+            // stopping early shouldn't leave any links behind
+            auto morris = MorrisBSTIterator(&node);
+            morris.next();
+        }
+        auto after_morris = BSTIterator(&node);
+        EXPECT_EQ(drain(after_morris), expected);
+
+        auto threaded = ThreadedBST(&node);
+        auto threaded_iter = ThreadedBSTIterator(threaded);
+        EXPECT_EQ(drain(threaded_iter), expected);
+    };
+
+    check(TN(1), 1);
+    check(TN(TN(1), 2, TN(3)), 3);
+    check(TN(TN(TN(1), 2), 3), 3);
+    check(TN(1, TN(2, TN(3))), 3);
+    check(TN(TN(1, TN(2)), 3, TN(TN(4), 5)), 5);
+    check(TN(TN(TN(1), 2, TN(3)), 4, TN(TN(5), 6, TN(7))), 7);
+}
+
+TEST(Solution, FrozenBST) {
+    auto check = [](const std::vector<int> &sorted) {
+        auto eytzinger = FrozenBST<EytzingerLayout>(sorted);
+        auto veb = FrozenBST<VanEmdeBoasLayout>(sorted);
+
+        EXPECT_EQ(std::vector<int>(eytzinger.begin(), eytzinger.end()), sorted);
+        EXPECT_EQ(std::vector<int>(veb.begin(), veb.end()), sorted);
+
+        long long min_key = sorted.empty() ? 0 : sorted.front();
+        long long max_key = sorted.empty() ? 0 : sorted.back();
+        for (auto wide_key = min_key - 2; wide_key <= std::min<long long>(max_key + 2, INT_MAX); ++wide_key) {
+            auto key = static_cast<int>(wide_key);
+            auto expected = static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin());
+            EXPECT_EQ(eytzinger.lowerBound(key), expected) << "n = " << sorted.size() << ", key = " << key;
+            EXPECT_EQ(veb.lowerBound(key), expected) << "n = " << sorted.size() << ", key = " << key;
+        }
+    };
+
+    for (int n = 0; n < 70; ++n) {
+        std::vector<int> sorted(n);
+        std::iota(sorted.begin(), sorted.end(), 0);
+        check(sorted);
+        // duplicates and gaps
+        for (auto &key : sorted) { key = (key / 3) * 5; }
+        check(sorted);
+    }
+    check({INT_MAX - 1, INT_MAX, INT_MAX});
+    auto tree = FrozenBST<VanEmdeBoasLayout>(std::vector<int>{INT_MAX - 1, INT_MAX, INT_MAX});
+    EXPECT_EQ(tree.lowerBound(INT_MAX), 1);
+
+    // frozen from a TreeNode
+    using TN = TreeNode;
+    auto root = TN(TN(TN(1), 2, TN(3)), 4, TN(TN(5), 6, TN(7)));
+    auto frozen = FrozenBST<VanEmdeBoasLayout>(&root);
+    EXPECT_EQ(std::vector<int>(frozen.begin(), frozen.end()), (std::vector<int>{1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_EQ(*frozen.lower_bound(4), 4);
+
+    std::vector<int> scanned;
+    frozen.scan(3, 6, [&](int key) { scanned.push_back(key); });
+    EXPECT_EQ(scanned, (std::vector<int>{3, 4, 5}));
+    scanned.clear();
+    frozen.scan(8, 10, [&](int key) { scanned.push_back(key); });
+    EXPECT_TRUE(scanned.empty());
+}
+
+TEST(Solution, SeekableBSTIterator) {
+    using TN = TreeNode;
+    auto check = [](TreeNode node, int num_nodes) {
+        auto drain = [](auto &iter) {
+            std::vector<int> actual;
+            while (iter.hasNext()) {
+                actual.push_back(iter.next());
+            }
+            return actual;
+        };
+
+        auto reverse = ReverseBSTIterator(&node);
+        std::vector<int> descending(num_nodes);
+        std::iota(descending.rbegin(), descending.rend(), 1);
+        EXPECT_EQ(drain(reverse), descending);
+
+        for (int key = 0; key <= num_nodes + 1; ++key) {
+            std::vector<int> expected;
+            for (int i = std::max(key, 1); i <= num_nodes; ++i) { expected.push_back(i); }
+
+            // seek after partially iterating too
+            auto iter = BSTIterator(&node);
+            iter.next();
+            iter.seek(key);
+            EXPECT_EQ(drain(iter), expected) << "key = " << key;
+
+            expected.clear();
+            for (int i = std::min(key, num_nodes); i >= 1; --i) { expected.push_back(i); }
+            reverse.seek(key);
+            EXPECT_EQ(drain(reverse), expected) << "key = " << key;
+        }
+
+        auto stats = OrderStatisticBST(&node);
+        EXPECT_EQ(stats.size(), num_nodes);
+        for (int k = 0; k < num_nodes; ++k) {
+            EXPECT_EQ(stats.nth(k), k + 1);
+        }
+        for (int key = 0; key <= num_nodes + 1; ++key) {
+            EXPECT_EQ(stats.rank(key), std::clamp(key - 1, 0, num_nodes));
+        }
+    };
+
+    check(TN(1), 1);
+    check(TN(TN(1), 2, TN(3)), 3);
+    check(TN(TN(TN(1), 2), 3), 3);
+    check(TN(1, TN(2, TN(3))), 3);
+    check(TN(TN(1, TN(2)), 3, TN(TN(4), 5)), 5);
+    check(TN(TN(TN(1), 2, TN(3)), 4, TN(TN(5), 6, TN(7))), 7);
+}
+
+static void insert(std::unique_ptr<TreeNode> &node, int key) {
+    if (!node) {
+        node = std::make_unique<TreeNode>(key);
+    } else if (key < node->val) {
+        insert(node->left, key);
+    } else if (key > node->val) {
+        insert(node->right, key);
+    }
+}
+
+static void inOrder(const TreeNode *node, std::vector<int> &out) {
+    if (!node) { return; }
+    inOrder(node->left.get(), out);
+    out.push_back(node->val);
+    inOrder(node->right.get(), out);
+}
+
+TEST(Differential, BSTIterator) {
+    // keys in insertion order, so that the trees come in all shapes
+    auto generate = [](std::mt19937_64 &rng) {
+        std::uniform_int_distribution<int> size_dist(1, 40);
+        std::vector<int> keys(size_dist(rng));
+        std::iota(keys.begin(), keys.end(), 0);
+        std::shuffle(keys.begin(), keys.end(), rng);
+        return keys;
+    };
+    auto shrink = [](const std::vector<int> &keys) {
+        return differential::shrinkSequence(keys);
+    };
+    auto holds = [](const std::vector<int> &keys) {
+        if (keys.empty()) { return true; }
+
+        std::unique_ptr<TreeNode> root;
+        for (int key : keys) { insert(root, key); }
+        std::vector<int> expected;
+        inOrder(root.get(), expected);
+        std::vector<int> reversed(expected.rbegin(), expected.rend());
+
+        auto drain = [](auto &&iter) {
+            std::vector<int> values;
+            while (iter.hasNext()) { values.push_back(iter.next()); }
+            return values;
+        };
+
+        bool ok = drain(BSTIterator(root.get())) == expected
+                  && drain(ReverseBSTIterator(root.get())) == reversed
+                  && drain(MorrisBSTIterator(root.get())) == expected
+                  && drain(ThreadedBSTIterator(ThreadedBST(root.get()))) == expected;
+        {
+            // stopping early has to restore the tree
+            MorrisBSTIterator morris(root.get());
+            morris.next();
+        }
+        std::vector<int> after_morris;
+        inOrder(root.get(), after_morris);
+        ok = ok && after_morris == expected;
+
+        for (int key = expected.front() - 1; key <= expected.back() + 1; ++key) {
+            BSTIterator forward(root.get());
+            forward.seek(key);
+            auto from = std::lower_bound(expected.begin(), expected.end(), key);
+            ok = ok && drain(forward) == std::vector<int>(from, expected.end());
+
+            ReverseBSTIterator backward(root.get());
+            backward.seek(key);
+            auto to = std::upper_bound(expected.begin(), expected.end(), key);
+            ok = ok && drain(backward) == std::vector<int>(std::make_reverse_iterator(to), expected.rend());
+        }
+        return ok;
+    };
+    differential::check(generate, shrink, holds);
+}
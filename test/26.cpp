@@ -0,0 +1,48 @@
+#include "problems/26.h"
+
+#include <algorithm>
+#include <random>
+#include <gtest/gtest.h>
+
+#include "differential.h"
+
+static void test(std::vector<int> nums, const std::vector<int> &expected) {
+    std::size_t new_len = Solution::removeDuplicates(nums);
+    nums.resize(std::min(new_len, nums.size()));
+
+    EXPECT_EQ(new_len, expected.size());
+    EXPECT_EQ(nums, expected);
+}
+
+TEST(Solution, removeDuplicatesFromSortedArray) {
+    test({}, {});
+    test({1}, {1});
+    test({1, 1}, {1});
+    test({1, 1, 1}, {1});
+    test({1, 1, 1, 2, 2, 3}, {1, 2, 3});
+    test({0, 0, 1, 1, 1, 1, 2, 3, 3}, {0, 1, 2, 3});
+}
+
+TEST(Differential, removeDuplicates) {
+    auto generate = [](std::mt19937_64 &rng) {
+        std::uniform_int_distribution<std::size_t> size_dist(0, 32);
+        std::uniform_int_distribution<int> value_dist(-8, 8);
+        std::vector<int> nums(size_dist(rng));
+        for (auto &x : nums) { x = value_dist(rng); }
+        std::sort(nums.begin(), nums.end());
+        return nums;
+    };
+    // removing elements keeps the input sorted
+    auto shrink = [](const std::vector<int> &nums) {
+        return differential::shrinkSequence(nums);
+    };
+    auto holds = [](std::vector<int> nums) {
+        auto expected = nums;
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+        auto new_len = Solution::removeDuplicates(nums);
+        return new_len == expected.size()
+               && std::equal(expected.begin(), expected.end(), nums.begin());
+    };
+    differential::check(generate, shrink, holds);
+}
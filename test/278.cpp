@@ -0,0 +1,163 @@
+#include "problems/278.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <gtest/gtest.h>
+
+static void test(int n, int bad) {
+    auto isBad = [bad](int m) { return m >= bad; };
+    auto actual = Solution::firstBadVersion(n, isBad);
+    EXPECT_EQ(actual, bad);
+}
+
+TEST(Solution, firstBadVersion) {
+    auto testAllN = [](int n) {
+        for (int i = 1; i < n; ++i)
+            test(n, i);
+    };
+
+    testAllN(1);
+    testAllN(5);
+    testAllN(6);
+    testAllN(12);
+}
+
+TEST(Solution, searchLowerBound) {
+    // firstTrue is a drop-in for firstBadVersion
+    for (int n = 1; n < 12; ++n) {
+        for (int bad = 1; bad <= n; ++bad) {
+            auto isBad = [bad](int m) { return m >= bad; };
+            EXPECT_EQ(search::firstTrue(1, n + 1, isBad), Solution::firstBadVersion(n, isBad));
+        }
+    }
+    EXPECT_EQ(search::firstTrue(0, 10, [](int) { return false; }), 10);
+    EXPECT_EQ(search::firstTrue(5, 5, [](int) { return true; }), 5);
+
+    std::mt19937 rng(std::mt19937::default_seed);
+    for (int n = 0; n < 200; ++n) {
+        // sorted, with duplicates and with a value range depending on n
+        std::uniform_int_distribution<int> value_dist(-n, 3 * n);
+        std::vector<int> data(n);
+        for (auto &value : data) { value = value_dist(rng); }
+        std::sort(data.begin(), data.end());
+
+        std::vector<int> keys;
+        for (int key = -n - 2; key <= 3 * n + 2; ++key) { keys.push_back(key); }
+        keys.push_back(INT_MIN);
+        keys.push_back(INT_MAX);
+
+        std::vector<std::size_t> batched(keys.size());
+        search::lowerBoundBatch(data, keys, batched);
+
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            auto key = keys[i];
+            auto expected = static_cast<std::size_t>(std::lower_bound(data.begin(), data.end(), key) - data.begin());
+            EXPECT_EQ(search::lowerBound(data, key), expected) << "n = " << n << ", key = " << key;
+            EXPECT_EQ(batched[i], expected) << "n = " << n << ", key = " << key;
+            EXPECT_EQ(search::interpolationLowerBound(data, key), expected) << "n = " << n << ", key = " << key;
+            EXPECT_EQ(search::exponentialLowerBound(data, key), expected) << "n = " << n << ", key = " << key;
+        }
+    }
+}
+
+TEST(Solution, firstBadVersionParallel) {
+    WorkStealingPool pool{4};
+
+    for (std::size_t arity : {2, 3, 5}) {
+        for (int n = 1; n < 40; ++n) {
+            for (int bad = 1; bad <= n + 1; ++bad) {
+                std::mutex mutex;
+                std::map<int, int> calls;
+                auto isBad = [&](int m) {
+                    std::lock_guard lock(mutex);
+                    calls[m] += 1;
+                    return m >= bad;
+                };
+
+                EXPECT_EQ(search::firstTrueParallel(1, n + 1, arity, isBad, pool), bad)
+                    << "arity = " << arity << ", n = " << n << ", bad = " << bad;
+                for (auto [m, count] : calls) {
+                    EXPECT_EQ(count, 1) << "version " << m << " checked more than once";
+                }
+            }
+        }
+    }
+
+    // predicates that take a std::stop_token
+    for (int bad : {3, 100, 500, 997}) {
+        auto isBad = [bad](int m, std::stop_token) { return m >= bad; };
+        EXPECT_EQ(search::firstTrueParallel(1, 1001, 4, isBad, pool), bad);
+    }
+
+    // Handshakes for checking cancellation: waitForStop() blocks until the
+    // probe is cancelled and records that it was, and waitForStarted(n)
+    // until n probes are blocked in it, so that they're definitely running
+    // rather than still queued (queued ones are skipped without a call).
+    // The deadlines only keep a broken implementation from hanging the test.
+    std::mutex mutex;
+    std::condition_variable_any changed;
+    std::set<std::int64_t> started;
+    std::set<std::int64_t> cancelled;
+    std::set<std::int64_t> timed_out;
+    auto deadline = [] { return std::chrono::steady_clock::now() + std::chrono::seconds(10); };
+    auto waitForStop = [&](std::int64_t m, std::stop_token stop) {
+        std::unique_lock lock(mutex);
+        started.insert(m);
+        changed.notify_all();
+        changed.wait_until(lock, stop, deadline(), [] { return false; });
+        (stop.stop_requested() ? cancelled : timed_out).insert(m);
+    };
+    auto waitForStarted = [&](std::size_t count) {
+        std::unique_lock lock(mutex);
+        if (!changed.wait_until(lock, deadline(), [&] { return started.size() >= count; })) {
+            timed_out.insert(-1);
+        }
+    };
+
+    // the first round probes 251, 501 and 751, and the last two can only
+    // return by being cancelled once 251 comes back bad
+    auto isBadAfter3 = [&](std::int64_t m, std::stop_token stop) {
+        if (m >= 501) {
+            waitForStop(m, stop);
+            return true;
+        }
+        if (m == 251) { waitForStarted(2); }
+        return m >= 3;
+    };
+    EXPECT_EQ(search::firstTrueParallel(1, 1001, 4, isBadAfter3, pool), 3);
+    EXPECT_EQ(cancelled, (std::set<std::int64_t>{501, 751}));
+    EXPECT_TRUE(timed_out.empty());
+
+    // errors are passed on to the caller
+    auto throwing = [](int) -> bool { throw std::runtime_error("check failed"); };
+    EXPECT_THROW(search::firstTrueParallel(1, 100, 4, throwing, pool), std::runtime_error);
+
+    // and every other probe is cancelled, here the first round probes 26,
+    // 51 and 76 and the last two can only return that way
+    started.clear();
+    cancelled.clear();
+    auto throwingFirst = [&](std::int64_t m, std::stop_token stop) -> bool {
+        if (m >= 50) {
+            waitForStop(m, stop);
+            return true;
+        }
+        waitForStarted(2);
+        throw std::runtime_error("check failed");
+    };
+    EXPECT_THROW(search::firstTrueParallel(1, 101, 4, throwingFirst, pool), std::runtime_error);
+    EXPECT_EQ(cancelled, (std::set<std::int64_t>{51, 76}));
+    EXPECT_TRUE(timed_out.empty());
+
+    // every int version is representable, unlike with int bounds
+    for (std::int64_t bad : {std::int64_t(1), std::int64_t(INT_MAX) - 1, std::int64_t(INT_MAX),
+                             std::int64_t(INT_MAX) + 1}) {
+        auto isBad = [bad](std::int64_t m) { return m >= bad; };
+        EXPECT_EQ(search::firstTrueParallel(1, std::int64_t(INT_MAX) + 1, 4, isBad, pool), bad);
+    }
+}
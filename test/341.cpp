@@ -0,0 +1,325 @@
+#include "problems/341.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <gtest/gtest.h>
+
+#include "differential.h"
+
+TEST(Solution, FlattenNestedIterator) {
+    auto checkCase = [](const std::vector<NestedInteger>& nested,
+                        const std::vector<int>& expected) {
+
+        NestedIterator it{nested};
+        std::vector<int> actual;
+        while (it.hasNext()) {
+            actual.push_back(it.next());
+        }
+
+        EXPECT_EQ(actual, expected);
+
+        FlatNestedList flat{nested};
+        FlatNestedIterator flat_it{flat};
+        std::vector<int> flat_actual;
+        while (flat_it.hasNext()) {
+            flat_actual.push_back(flat_it.next());
+        }
+
+        EXPECT_EQ(flat_actual, expected);
+        EXPECT_EQ(flat.size(), expected.size());
+    };
+
+    checkCase({
+                      std::vector<NestedInteger>{1, std::vector<NestedInteger>{2, 3}},
+                      4,
+                      std::vector<NestedInteger>{std::vector<NestedInteger>{}},
+                      std::vector<NestedInteger>{5, 6},
+                      7,
+                      std::vector<NestedInteger>{}
+              }, {1, 2, 3, 4, 5, 6, 7});
+
+    checkCase({1}, {1});
+    checkCase({1, 2}, {1, 2});
+    checkCase({std::vector<NestedInteger>{}, 1}, {1});
+    checkCase({std::vector<NestedInteger>{std::vector<NestedInteger>{std::vector<NestedInteger>{1}}}}, {1});
+    checkCase({}, {});
+    checkCase({std::vector<NestedInteger>{}}, {});
+}
+
+TEST(Solution, FlatNestedList) {
+    // [1, [2, []], 3]
+    FlatNestedList flat{{
+        1,
+        std::vector<NestedInteger>{2, std::vector<NestedInteger>{}},
+        3
+    }};
+
+    auto &tokens = flat.tokens();
+    ASSERT_EQ(tokens.size(), 5);
+    EXPECT_TRUE(tokens[0].isInteger());
+    EXPECT_EQ(tokens[0].value_, 1);
+    EXPECT_EQ(tokens[1].span_, 3);
+    EXPECT_EQ(tokens[2].value_, 2);
+    EXPECT_EQ(tokens[3].span_, 1);
+    EXPECT_EQ(tokens[4].value_, 3);
+    // skipping the list at index 1 takes us straight to `3`
+    EXPECT_EQ(&tokens[1] + tokens[1].extent(), &tokens[4]);
+    EXPECT_FALSE(tokens[1].isEmptyList());
+    EXPECT_TRUE(tokens[3].isEmptyList());
+
+    // [[[], [[]]], 1], the first list has no integers at any depth
+    FlatNestedList nested_empty{{
+        std::vector<NestedInteger>{
+            std::vector<NestedInteger>{},
+            std::vector<NestedInteger>{std::vector<NestedInteger>{}}
+        },
+        1
+    }};
+    auto &empty_tokens = nested_empty.tokens();
+    ASSERT_EQ(empty_tokens.size(), 5);
+    EXPECT_TRUE(empty_tokens[0].isEmptyList());
+    EXPECT_EQ(empty_tokens[0].extent(), 4);
+    EXPECT_TRUE(empty_tokens[2].isEmptyList());
+    EXPECT_EQ(empty_tokens[4].value_, 1);
+
+    FlatNestedIterator it{nested_empty};
+    ASSERT_TRUE(it.hasNext());
+    EXPECT_EQ(it.next(), 1);
+    EXPECT_FALSE(it.hasNext());
+}
+
+TEST(Solution, NestedTextIterator) {
+    auto parse = [](std::string_view text) {
+        NestedTextIterator it{text};
+        std::vector<int> actual;
+        while (it.hasNext()) {
+            actual.push_back(it.next());
+        }
+        EXPECT_EQ(it.depth(), 0);
+        return actual;
+    };
+
+    EXPECT_EQ(parse("[]"), std::vector<int>{});
+    EXPECT_EQ(parse("[[],[[]]]"), std::vector<int>{});
+    EXPECT_EQ(parse("[1]"), std::vector<int>{1});
+    EXPECT_EQ(parse("[[1,1],2,[1,1]]"), (std::vector<int>{1, 1, 2, 1, 1}));
+    EXPECT_EQ(parse("[1,[4,[6]]]"), (std::vector<int>{1, 4, 6}));
+    EXPECT_EQ(parse(" [ -1 , [ 20 ] ]\n[3]\n"), (std::vector<int>{-1, 20, 3}));
+    EXPECT_EQ(parse("[2147483647,-2147483648]"), (std::vector<int>{2147483647, -2147483648}));
+    // long enough for the vectorized digit path, with digits at the end
+    EXPECT_EQ(parse("[1234567890,0000000001," + std::string(16, '[') + "42" + std::string(17, ']')),
+              (std::vector<int>{1234567890, 1, 42}));
+
+    EXPECT_THROW(parse("[1,2"), std::invalid_argument);
+    EXPECT_THROW(parse("[1]]"), std::invalid_argument);
+    EXPECT_THROW(parse("1"), std::invalid_argument);
+    EXPECT_THROW(parse("[a]"), std::invalid_argument);
+    EXPECT_THROW(parse("[-]"), std::invalid_argument);
+    EXPECT_THROW(parse("[2147483648]"), std::invalid_argument);
+    EXPECT_THROW(parse("[12345678901]"), std::invalid_argument);
+    EXPECT_THROW(parse("[1 2]"), std::invalid_argument);
+    EXPECT_THROW(parse("[,,1,,]"), std::invalid_argument);
+    EXPECT_THROW(parse("[1,]"), std::invalid_argument);
+    EXPECT_THROW(parse("[,1]"), std::invalid_argument);
+    EXPECT_THROW(parse("[1[2]]"), std::invalid_argument);
+    EXPECT_THROW(parse("[[1][2]]"), std::invalid_argument);
+    EXPECT_THROW(parse("[1,2],"), std::invalid_argument);
+    EXPECT_THROW(parse("[1-2]"), std::invalid_argument);
+
+#if __has_include(<sys/mman.h>)
+    auto path = std::string(::testing::TempDir()) + "nested_text_iterator.txt";
+    {
+        auto file = std::fopen(path.c_str(), "w");
+        ASSERT_NE(file, nullptr);
+        std::fputs("[1,[2,3],4]", file);
+        std::fclose(file);
+    }
+    {
+        MappedFile mapped{path};
+        EXPECT_EQ(parse(mapped.view()), (std::vector<int>{1, 2, 3, 4}));
+    }
+    std::remove(path.c_str());
+#endif
+}
+
+TEST(Solution, ParallelNested) {
+    auto checkCase = [](const std::vector<NestedInteger> &nested, WorkStealingPool &pool) {
+        std::vector<int> expected;
+        NestedIterator it{nested};
+        while (it.hasNext()) {
+            expected.push_back(it.next());
+        }
+
+        EXPECT_EQ(parallelFlatten(nested, pool), expected);
+
+        auto is_odd = [](int value) { return value % 2 != 0; };
+        std::vector<int> expected_odd;
+        std::copy_if(expected.begin(), expected.end(), std::back_inserter(expected_odd), is_odd);
+        EXPECT_EQ(parallelCopyIf(nested, is_odd, pool), expected_odd);
+
+        auto expected_sum = std::accumulate(expected.begin(), expected.end(), 0LL);
+        EXPECT_EQ(parallelReduce(nested, 0LL, std::plus<>(), pool), expected_sum);
+        EXPECT_EQ(parallelTransformReduce(nested, std::size_t(0), std::plus<>(),
+                                          [](int) { return std::size_t(1); }, pool),
+                  expected.size());
+        // init is added exactly once, no matter how many sub-lists are split off
+        EXPECT_EQ(parallelReduce(nested, 100LL, std::plus<>(), pool), expected_sum + 100);
+
+        std::atomic<long long> for_each_sum = 0;
+        parallelForEach(nested, [&](int value) { for_each_sum += value; }, pool);
+        EXPECT_EQ(for_each_sum, expected_sum);
+    };
+
+    // big enough lists to actually get split up, at different depths
+    auto makeList = [](int first, int size) {
+        std::vector<NestedInteger> list;
+        for (int i = first; i < first + size; ++i) {
+            list.emplace_back(i);
+        }
+        return list;
+    };
+    std::vector<NestedInteger> large = makeList(0, 3000);
+    large[10] = makeList(10000, 5000);
+    large[2500] = std::vector<NestedInteger>{
+        std::vector<NestedInteger>{makeList(20000, 1024), makeList(30000, 1023)},
+        std::vector<NestedInteger>{},
+        -1
+    };
+    std::vector<NestedInteger> wrapped = {std::vector<NestedInteger>{large}, 7, large};
+
+    for (std::size_t num_threads : {1, 4}) {
+        WorkStealingPool pool{num_threads};
+        checkCase({}, pool);
+        checkCase({std::vector<NestedInteger>{}}, pool);
+        checkCase({1, std::vector<NestedInteger>{2, std::vector<NestedInteger>{3}}, 4}, pool);
+        checkCase(makeList(0, 1024), pool);
+        checkCase(large, pool);
+        checkCase(wrapped, pool);
+    }
+}
+
+#ifdef CLOCK_THREAD_CPUTIME_ID
+TEST(Solution, TaskGroupSleepsWhileWaiting) {
+    auto cpuTime = [] {
+        timespec time{};
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+    };
+
+    // one long task and nothing else to run, so the waiting thread should
+    // sleep rather than spin (which would use up about as much CPU time as
+    // the task takes, more load can only make it use less)
+    WorkStealingPool pool{1};
+    std::atomic<bool> started = false;
+    std::atomic<bool> release = false;
+    std::chrono::nanoseconds waiter_cpu_time{};
+    std::thread waiter([&] {
+        TaskGroup group(pool);
+        group.spawn([&] {
+            started = true;
+            while (!release) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+        });
+        // make sure the pool's worker has the task, otherwise wait() runs it
+        while (!started) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+        auto start = cpuTime();
+        group.wait();
+        waiter_cpu_time = cpuTime() - start;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    release = true;
+    waiter.join();
+    EXPECT_LT(waiter_cpu_time, std::chrono::milliseconds(100));
+}
+#endif
+
+static std::string toText(const std::vector<NestedInteger> &nested) {
+    std::string text = "[";
+    for (auto &item : nested) {
+        if (text.size() > 1) { text += ','; }
+        text += item.isInteger() ? std::to_string(item.getInteger()) : toText(item.getList());
+    }
+    text += ']';
+    return text;
+}
+
+static void PrintTo(const NestedInteger &item, std::ostream *out) {
+    *out << (item.isInteger() ? std::to_string(item.getInteger()) : toText(item.getList()));
+}
+
+static void flattenRecursive(const std::vector<NestedInteger> &nested, std::vector<int> &out) {
+    for (auto &item : nested) {
+        if (item.isInteger()) {
+            out.push_back(item.getInteger());
+        } else {
+            flattenRecursive(item.getList(), out);
+        }
+    }
+}
+
+static std::vector<NestedInteger> makeRandomNested(std::mt19937_64 &rng, int depth) {
+    std::uniform_int_distribution<std::size_t> size_dist(0, 4);
+    std::uniform_int_distribution<int> kind_dist(0, 9);
+    std::uniform_int_distribution<int> value_dist(-50, 50);
+
+    std::vector<NestedInteger> list;
+    for (auto n = size_dist(rng); n > 0; --n) {
+        auto kind = kind_dist(rng);
+        if (kind < 3 && depth > 0) {
+            list.emplace_back(makeRandomNested(rng, depth - 1));
+        } else if (kind == 3) {
+            // the extremes are the interesting cases for the text parser
+            list.emplace_back(value_dist(rng) < 0 ? INT_MIN : INT_MAX);
+        } else {
+            list.emplace_back(value_dist(rng));
+        }
+    }
+    return list;
+}
+
+static std::vector<std::vector<NestedInteger>> shrinkNested(const std::vector<NestedInteger> &nested) {
+    auto simplify = [](const NestedInteger &item) {
+        std::vector<NestedInteger> simpler;
+        if (item.isInteger()) {
+            for (int value : differential::shrinkInt(item.getInteger())) { simpler.emplace_back(value); }
+        } else {
+            for (auto &list : shrinkNested(item.getList())) { simpler.emplace_back(std::move(list)); }
+            simpler.emplace_back(0);
+        }
+        return simpler;
+    };
+    return differential::shrinkSequence(nested, simplify);
+}
+
+TEST(Differential, NestedIterator) {
+    auto generate = [](std::mt19937_64 &rng) {
+        return makeRandomNested(rng, 4);
+    };
+    auto holds = [](const std::vector<NestedInteger> &nested) {
+        std::vector<int> expected;
+        flattenRecursive(nested, expected);
+
+        auto drain = [](auto &&iter) {
+            std::vector<int> values;
+            while (iter.hasNext()) { values.push_back(iter.next()); }
+            return values;
+        };
+        FlatNestedList flat(nested);
+        return drain(NestedIterator(nested)) == expected
+               && drain(FlatNestedIterator(flat)) == expected
+               && flat.size() == expected.size()
+               && drain(NestedTextIterator(toText(nested))) == expected;
+    };
+    differential::check(generate, shrinkNested, holds);
+}
@@ -0,0 +1,129 @@
+#include "problems/44.h"
+
+#include <random>
+#include <gtest/gtest.h>
+
+#include "differential.h"
+
+static void checkOne(const std::string &input, const std::string &pattern) {
+    bool expected = isMatchRegex(input, pattern);
+    bool actual = Solution::isMatch(input, pattern);
+    EXPECT_EQ(expected, actual)
+        << "  input:   " << input << '\n'
+        << "  pattern: " << pattern;
+}
+
+static void checkCase(const std::string &input, const std::string &pattern) {
+    checkOne(input, pattern);
+    checkOne(input + "a", pattern + "a");
+    checkOne(input + "z", pattern + "?");
+    checkOne(input + "z", pattern);
+    checkOne("z" + input, pattern);
+    checkOne(input, pattern + "*");
+    checkOne(input, "*" + pattern);
+    checkOne(input, pattern + "?");
+    checkOne(input, "?" + pattern);
+    checkOne(input + "z", pattern + "?");
+    checkOne("z" + input, "?" + pattern);
+    checkOne(input + "abcd", pattern + "*");
+    checkOne("abcd" + input, "*" + pattern);
+}
+
+TEST(Solution, WildcardMatching) {
+    checkCase("", "?");
+    checkCase("", "*");
+    checkCase("", "");
+    checkCase("a", "?");
+    checkCase("a", "*");
+    checkCase("a", "a");
+    checkCase("a", "z");
+    checkCase("aa", "a");
+    checkCase("aa", "*");
+    checkCase("cb", "?a");
+    checkCase("adceb", "*a*b");
+    checkCase("acdcb", "a*c?b");
+    checkCase("acdcbacdcbacdcbacdcbacdcb",
+              "a*c?ba*c?ba*c?ba*c?ba*c?b");
+    checkCase("", "***********");
+    checkCase("a", "***********");
+
+    std::string pathological_str = "abcdefghijklmnopqrstuvwxyz"
+                                   "abcdefghijklmnopqrstuvwxyz"
+                                   "abcdefghijklmnopqrstuvwxyz"
+                                   "abcdefghijklmnopqrstuvwxyz";
+    std::string pathological_pat = "a*b*c*d*e*f*g*h*i*j*k*l*m*n*o*p*q*r*s*t*u*v*w*x*y*z*"
+                                   "a*b*c*d*e*f*g*h*i*j*k*l*m*n*o*p*q*r*s*t*u*v*w*x*y*z*"
+                                   "a*b*c*d*e*f*g*h*i*j*k*l*m*n*o*p*q*r*s*t*u*v*w*x*y*z*"
+                                   "a*b*c*d*e*f*g*h*i*j*k*l*m*n*o*p*q*r*s*t*u*v*w*x*y*z*";
+    checkCase(pathological_str, pathological_pat);
+
+    std::string pathological_str2;
+    std::string pathological_pat2;
+    for (int i = 0; i < 1000; ++i) {
+        char next = static_cast<char>('a' + (i % 26));
+        pathological_str2 += next;
+        pathological_pat2 += next;
+        pathological_pat2 += '*';
+    }
+    EXPECT_EQ(Solution::isMatch(pathological_str2, pathological_pat2), true);
+    pathological_str2 += "x";
+    EXPECT_EQ(Solution::isMatch(pathological_str2, pathological_pat2), true);
+    pathological_str2 += "x";
+    pathological_pat2 += "?";
+    EXPECT_EQ(Solution::isMatch(pathological_str2, pathological_pat2), true);
+    pathological_str2 += "a";
+    pathological_pat2 += "b";
+    EXPECT_EQ(Solution::isMatch(pathological_str2, pathological_pat2), false);
+
+    std::string pathological_str3(1000, 'a');
+    pathological_str3[0] = 'z';
+    std::string pathological_pat3(1000, '*');
+    pathological_pat3[pathological_pat3.size() - 2] = 'z';
+    EXPECT_EQ(Solution::isMatch(pathological_str3, pathological_pat3), true);
+
+    std::string pathological_str4 = pathological_str3;
+    std::string pathological_pat4;
+    for (std::size_t i = 0; i < pathological_str4.size(); ++i) {
+        pathological_pat4 += "*?";
+    }
+    pathological_pat4[1] = 'z';
+    EXPECT_EQ(Solution::isMatch(pathological_str4, pathological_pat4), true);
+    EXPECT_EQ(Solution::isMatch("abbbabaaabbabbabbabaabbbaabaaaabbbabaaabbbbbaaababbb", "*a*b*aa*b*bbb*ba*a"), false);
+    EXPECT_EQ(Solution::isMatch("abbbabaaabbabbabbabaabbbaabaaaabbbabaaabbbbbaaababbb", "**a*b*aa***b***bbb*ba*a"), false);
+    EXPECT_EQ(Solution::isMatch("abbbabaaabbabbabbabaabbbaabaaaabbbabaaabbbbbaaababbbabbbabaaabbabbabbabaabbbaabaaaabbbabaaabbbbbaaababbb",
+                                "*a*b*aa*b*bbb*ba*a*a*b*aa*b*bbb*ba*a"), false);
+}
+
+TEST(Differential, WildcardMatching) {
+    using Input = std::pair<std::string, std::string>;
+    // small alphabets so that matches are actually likely
+    auto generate = [](std::mt19937_64 &rng) {
+        std::uniform_int_distribution<std::size_t> size_dist(0, 12);
+        auto makeString = [&](std::string_view alphabet) {
+            std::uniform_int_distribution<std::size_t> char_dist(0, alphabet.size() - 1);
+            std::string str(size_dist(rng), ' ');
+            for (auto &c : str) { c = alphabet[char_dist(rng)]; }
+            return str;
+        };
+        auto input = makeString("ab");
+        return Input{input, makeString("ab?*")};
+    };
+    // simplify every character towards 'a'
+    auto simplify = [](char c) {
+        return c == 'a' ? std::vector<char>{} : std::vector<char>{'a'};
+    };
+    auto shrink = [&](const Input &input) {
+        std::vector<Input> candidates;
+        for (auto &str : differential::shrinkSequence(input.first, simplify)) {
+            candidates.emplace_back(str, input.second);
+        }
+        for (auto &pattern : differential::shrinkSequence(input.second, simplify)) {
+            candidates.emplace_back(input.first, pattern);
+        }
+        return candidates;
+    };
+    auto holds = [](const Input &input) {
+        return Solution::isMatch(input.first, input.second) == isMatchRegex(input.first, input.second);
+    };
+    differential::check(generate, shrink, holds);
+}
@@ -0,0 +1,105 @@
+#include "problems/88.h"
+
+#include <algorithm>
+#include <random>
+#include <gtest/gtest.h>
+
+#include "differential.h"
+
+static void test(std::vector<int> nums1, int m,
+                 std::vector<int> nums2, int n,
+                 const std::vector<int> &expected) {
+    Solution::merge(nums1, m, nums2, n);
+    EXPECT_EQ(nums1, expected);
+}
+
+TEST(Solution, mergeSortedArray) {
+    test(
+            {1, 2, 3, 0, 0, 0}, 3,
+            {2, 5, 6}, 3,
+            {1, 2, 2, 3, 5, 6}
+    );
+    test(
+            {1, 2, 3, 0, 0, 0}, 3,
+            {1, 2, 2}, 3,
+            {1, 1, 2, 2, 2, 3}
+    );
+    // m == 0
+    test(
+            {0, 0, 0}, 0,
+            {1, 2, 3}, 3,
+            {1, 2, 3}
+    );
+    // n == 0
+    test(
+            {1, 2, 3}, 3,
+            {}, 0,
+            {1, 2, 3}
+    );
+    // m == n == 0
+    test(
+            {}, 0,
+            {}, 0,
+            {}
+    );
+    // nums1 < nums2
+    test(
+            {1, 2, 3, 0, 0, 0}, 3,
+            {4, 5, 6}, 3,
+            {1, 2, 3, 4, 5, 6}
+    );
+    // nums2 < nums1
+    test(
+            {4, 5, 6, 0, 0, 0}, 3,
+            {1, 2, 3}, 3,
+            {1, 2, 3, 4, 5, 6}
+    );
+    test(
+            {3, 0, 0, 0}, 1,
+            {1, 2, 4}, 3,
+            {1, 2, 3, 4}
+    );
+    test(
+            {1, 2, 4, 0}, 3,
+            {3}, 1,
+            {1, 2, 3, 4}
+    );
+}
+
+TEST(Differential, merge) {
+    using Input = std::pair<std::vector<int>, std::vector<int>>;
+    auto generate = [](std::mt19937_64 &rng) {
+        std::uniform_int_distribution<std::size_t> size_dist(0, 16);
+        std::uniform_int_distribution<int> value_dist(-8, 8);
+        auto makeSorted = [&] {
+            std::vector<int> nums(size_dist(rng));
+            for (auto &x : nums) { x = value_dist(rng); }
+            std::sort(nums.begin(), nums.end());
+            return nums;
+        };
+        auto nums1 = makeSorted();
+        return Input{nums1, makeSorted()};
+    };
+    auto shrink = [](const Input &input) {
+        std::vector<Input> candidates;
+        for (auto &nums1 : differential::shrinkSequence(input.first)) {
+            candidates.emplace_back(nums1, input.second);
+        }
+        for (auto &nums2 : differential::shrinkSequence(input.second)) {
+            candidates.emplace_back(input.first, nums2);
+        }
+        return candidates;
+    };
+    auto holds = [](const Input &input) {
+        auto [nums1, nums2] = input;
+        std::vector<int> expected;
+        std::merge(nums1.begin(), nums1.end(), nums2.begin(), nums2.end(), std::back_inserter(expected));
+
+        auto m = static_cast<int>(nums1.size());
+        auto n = static_cast<int>(nums2.size());
+        nums1.resize(m + n, 0);
+        Solution::merge(nums1, m, nums2, n);
+        return nums1 == expected;
+    };
+    differential::check(generate, shrink, holds);
+}
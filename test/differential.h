@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+// Randomized differential testing: a property compares a solution against
+// a simple reference implementation on generated inputs, and the first
+// input it fails on is shrunk to a minimal repro before being reported.
+//
+// LEETCODE_FUZZ_ITERATIONS sets the number of inputs per property and
+// LEETCODE_FUZZ_SEED the seed, which is printed with every failure so that
+// it can be replayed.
+namespace differential {
+    struct Options {
+        std::size_t iterations_;
+        std::uint64_t seed_;
+    };
+
+    inline Options options() {
+        Options options{500, std::mt19937_64::default_seed};
+        if (auto *iterations = std::getenv("LEETCODE_FUZZ_ITERATIONS")) {
+            options.iterations_ = std::strtoull(iterations, nullptr, 10);
+        }
+        if (auto *seed = std::getenv("LEETCODE_FUZZ_SEED")) {
+            options.seed_ = std::strtoull(seed, nullptr, 10);
+        }
+        return options;
+    }
+
+    // @return Candidates one step simpler than `seq`: chunks of decreasing
+    //         size removed, then single elements replaced by `simplify(x)`
+    //         (which returns a list of simpler values).
+    template<class Seq, class Simplify>
+    std::vector<Seq> shrinkSequence(const Seq &seq, Simplify &&simplify) {
+        std::vector<Seq> candidates;
+        for (auto chunk = seq.size(); chunk > 0; chunk /= 2) {
+            for (std::size_t first = 0; first + chunk <= seq.size(); first += chunk) {
+                Seq smaller;
+                smaller.insert(smaller.end(), seq.begin(), seq.begin() + first);
+                smaller.insert(smaller.end(), seq.begin() + first + chunk, seq.end());
+                candidates.push_back(std::move(smaller));
+            }
+        }
+        for (std::size_t i = 0; i < seq.size(); ++i) {
+            for (auto &simpler : simplify(seq[i])) {
+                auto copy = seq;
+                copy[i] = simpler;
+                candidates.push_back(std::move(copy));
+            }
+        }
+        return candidates;
+    }
+
+    template<class Seq>
+    std::vector<Seq> shrinkSequence(const Seq &seq) {
+        return shrinkSequence(seq, [](const auto &) { return std::vector<typename Seq::value_type>{}; });
+    }
+
+    // Shrinks towards 0, e.g. for integers in generated inputs.
+    inline std::vector<int> shrinkInt(int x) {
+        if (x == 0) { return {}; }
+        if (x / 2 == 0) { return {0}; }
+        return {0, x / 2};
+    }
+
+    // Greedily replaces `input` with the first of `shrink(input)` that still
+    // fails until none do.
+    template<class T, class Shrink, class Property>
+    T minimize(T input, Shrink &&shrink, Property &&holds) {
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            for (auto &candidate : shrink(input)) {
+                if (!holds(candidate)) {
+                    input = std::move(candidate);
+                    progress = true;
+                    break;
+                }
+            }
+        }
+        return input;
+    }
+
+    // Checks `holds(input)` for inputs from `generate(rng)`, stopping at the
+    // first failure and reporting its shrunk version. Inputs are printed
+    // with gtest's printers, so custom types need a PrintTo or operator<<.
+    template<class Generate, class Shrink, class Property>
+    void check(Generate &&generate, Shrink &&shrink, Property &&holds) {
+        auto [iterations, seed] = options();
+        std::mt19937_64 rng(seed);
+        for (std::size_t i = 0; i < iterations; ++i) {
+            auto input = generate(rng);
+            if (holds(input)) { continue; }
+
+            auto minimal = minimize(input, shrink, holds);
+            ADD_FAILURE() << "property failed on input " << i << " with LEETCODE_FUZZ_SEED=" << seed << "\n"
+                          << "  minimal input:  " << ::testing::PrintToString(minimal) << "\n"
+                          << "  original input: " << ::testing::PrintToString(input);
+            return;
+        }
+    }
+}
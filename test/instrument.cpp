@@ -0,0 +1,59 @@
+#include "util/instrument.h"
+#include "problems/146.h"
+
+#include <memory>
+#include <gtest/gtest.h>
+
+// stops the compiler from eliding the allocations in the tests
+static void *volatile sink;
+
+TEST(Instrument, allocationStats) {
+    if (!instrument::allocationsTracked()) {
+        GTEST_SKIP() << "built without LEETCODE_INSTRUMENT";
+    }
+
+    auto before = instrument::allocationStats();
+    {
+        auto value = std::make_unique<long long>(1);
+        sink = value.get();
+        // over-aligned allocations go through a separate operator new
+        struct alignas(64) Line { char bytes_[64]; };
+        auto line = std::make_unique<Line>();
+        sink = line.get();
+    }
+    auto after = instrument::allocationStats();
+    EXPECT_EQ(after.allocations_ - before.allocations_, 2);
+    EXPECT_EQ(after.deallocations_ - before.deallocations_, 2);
+    EXPECT_EQ(after.bytes_ - before.bytes_, sizeof(long long) + 64);
+
+    // the constructor reserves space, so puts only allocate the map node
+    // and gets don't allocate at all
+    LRUCache cache(4);
+    before = instrument::allocationStats();
+    cache.put(1, 1);
+    EXPECT_EQ(instrument::allocationStats().allocations_ - before.allocations_, 1);
+
+    before = instrument::allocationStats();
+    EXPECT_EQ(cache.get(1), 1);
+    EXPECT_EQ(cache.get(2), -1);
+    cache.put(1, 2);
+    EXPECT_EQ(instrument::allocationStats().allocations_ - before.allocations_, 0);
+}
+
+TEST(Instrument, PerfCounters) {
+    instrument::PerfCounters counters;
+    if (!counters.anyAvailable()) {
+        // not an error, e.g. VMs often don't expose a PMU
+        EXPECT_NE(counters.error(), 0);
+        EXPECT_FALSE(counters.read(instrument::Event::cycles));
+        GTEST_SKIP() << "perf_event_open is not available";
+    }
+
+    auto before = counters.read(instrument::Event::instructions);
+    volatile long long sum = 0;
+    for (int i = 0; i < 100'000; ++i) { sum = sum + i; }
+    auto after = counters.read(instrument::Event::instructions);
+    if (before && after) {
+        EXPECT_GE(*after - *before, 100'000);
+    }
+}